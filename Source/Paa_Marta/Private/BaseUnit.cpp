@@ -5,8 +5,6 @@
 #include "Kismet/GameplayStatics.h"
 #include "UObject/ConstructorHelpers.h"
 #include "Kismet/KismetMathLibrary.h"
-#include "Containers/Queue.h"
-#include "Containers/Map.h"
 
 // Restituisce una descrizione dell'unit in base al team e al tipo
 FString ABaseUnit::GetUnitDescription(const ABaseUnit* Unit)
@@ -60,6 +58,22 @@ void ABaseUnit::BeginPlay()
     Super::BeginPlay();
 }
 
+// Quando l'unit viene distrutta la sua cella torna libera
+void ABaseUnit::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    if (EndPlayReason == EEndPlayReason::Destroyed)
+    {
+        AMyGameMode* GM = Cast<AMyGameMode>(UGameplayStatics::GetGameMode(GetWorld()));
+        AGridManager* GridManager = GM ? GM->GridManager : nullptr;
+        if (GridManager && GridManager->IsValidCell(CurrentCellIndex) && GridManager->GetOccupyingUnit(CurrentCellIndex) == this)
+        {
+            GridManager->ClearCellOccupant(CurrentCellIndex);
+        }
+    }
+
+    Super::EndPlay(EndPlayReason);
+}
+
 void ABaseUnit::Tick(float DeltaTime)
 {
     Super::Tick(DeltaTime);
@@ -73,15 +87,15 @@ void ABaseUnit::Initialize(EUnitType Type, ETeamType Team)
 }
 
 // Posiziona l'unit sulla cella della griglia 
-void ABaseUnit::PlaceOnGrid(AGridCell* Cell)
+void ABaseUnit::PlaceOnGrid(int32 CellIndex)
 {
-    if (Cell)
+    AGridManager* GridManager = AGridManager::GetInstance(GetWorld());
+    if (GridManager && GridManager->IsValidCell(CellIndex))
     {
-        CurrentCell = Cell;
-        FVector CellLocation = Cell->GetActorLocation();
+        CurrentCellIndex = CellIndex;
+        FVector CellLocation = GridManager->GetCellLocation(CellIndex);
         SetActorLocation(FVector(CellLocation.X, CellLocation.Y, CellLocation.Z + 50.0f));
-        Cell->SetOccupied(true);
-        Cell->OccupyingUnit = this;
+        GridManager->SetCellOccupant(CellIndex, this);
     }
 }
 
@@ -94,9 +108,9 @@ void ABaseUnit::OnUnitClicked(UPrimitiveComponent* TouchedComponent, FKey Button
         return; // Se il gioco  finito o GameMode non valido, non fare nulla
     }
 
-    if (!CurrentCell)
+    if (CurrentCellIndex == INDEX_NONE || !GM->GridManager)
     {
-        UE_LOG(LogTemp, Warning, TEXT("Clicked unit has no valid CurrentCell."));
+        UE_LOG(LogTemp, Warning, TEXT("Clicked unit has no valid CurrentCellIndex."));
         return;
     }
 
@@ -107,15 +121,19 @@ void ABaseUnit::OnUnitClicked(UPrimitiveComponent* TouchedComponent, FKey Button
         GM->HUD->SetHealthBar(HealthMax, Health);
     }
 
+    // Selezione, movimento e attacco solo nel turno del giocatore (l'IA pu pensare in background per diversi frame)
+    if (GM->CurrentMovementTurn != EMovementTurn::Player)
+    {
+        return;
+    }
+
     // Gestione attacco su unit nemiche
     if (TeamType != ETeamType::Player)
     {
         // Controlla che ci sia un'unit selezionata e che questa abbia una cella valida
-        if (GM->SelectedUnitForMovement && GM->SelectedUnitForMovement->CurrentCell)
+        if (GM->SelectedUnitForMovement && GM->SelectedUnitForMovement->CurrentCellIndex != INDEX_NONE)
         {
-            int32 DeltaX = FMath::Abs(GM->SelectedUnitForMovement->CurrentCell->GridX - CurrentCell->GridX);
-            int32 DeltaY = FMath::Abs(GM->SelectedUnitForMovement->CurrentCell->GridY - CurrentCell->GridY);
-            int32 ManhattanDistance = DeltaX + DeltaY;
+            int32 ManhattanDistance = GM->GridManager->GetDistance(GM->SelectedUnitForMovement->CurrentCellIndex, CurrentCellIndex);
 
             bool bInRange = false;
 
@@ -138,7 +156,7 @@ void ABaseUnit::OnUnitClicked(UPrimitiveComponent* TouchedComponent, FKey Button
                 {
                     GM->SelectedUnitForMovement->bHasAttacked = true;
 
-                    FString TargetCellID = GM->GetCellIdentifier(CurrentCell);
+                    FString TargetCellID = GM->GetCellIdentifier(CurrentCellIndex);
                     int32 Damage = 5;
 
                     FString UnitPrefix;
@@ -193,104 +211,82 @@ void ABaseUnit::OnUnitClicked(UPrimitiveComponent* TouchedComponent, FKey Button
 
 
 // Muove l'unit verso la nuova cella specificata
-void ABaseUnit::MoveToCell(AGridCell* NewCell)
+// L'occupazione della griglia viene aggiornata subito, il movimento graduale  solo visivo
+void ABaseUnit::MoveToCell(int32 NewCellIndex)
 {
-    if (!NewCell || NewCell->bIsObstacle || NewCell->bIsOccupied)
+    AGridManager* GridManager = AGridManager::GetInstance(GetWorld());
+    if (!GridManager || !GridManager->IsValidCell(NewCellIndex) || !GridManager->IsWalkable(NewCellIndex))
     {
         UE_LOG(LogTemp, Warning, TEXT("Cannot move: invalid cell"));
         return;
     }
 
-    // Calcola il percorso minimo dalla cella attuale a quella di destinazione
-    TArray<AGridCell*> Path = ComputePath(CurrentCell, NewCell);
-    if (Path.Num() == 0)
+    // Se la destinazione  stata scelta tra le celle raggiungibili, il percorso  gi nell'albero della BFS in cache
+    TArray<int32> Path;
+    if (GridManager->GetCachedPath(CurrentCellIndex, NewCellIndex, Path))
     {
-        UE_LOG(LogTemp, Warning, TEXT("No path found to move"));
+        MoveAlongPath(Path);
         return;
     }
 
-    // Libera la cella attuale
-    if (CurrentCell)
-    {
-        CurrentCell->SetOccupied(false);
-    }
+    // Altrimenti viene cercato in background sullo stato attuale della griglia, entro il raggio di movimento,
+    // mentre la nuova posizione vale da subito per il resto del turno
+    const int32 FromCellIndex = CurrentCellIndex;
+    GridManager->RequestPath(FromCellIndex, NewCellIndex, MovementRange, FOnGridPathReady::CreateUObject(this, &ABaseUnit::OnMovePathReady, FromCellIndex));
 
-    // Salva il percorso e inizia il movimento graduale
-    MovementPath = Path;
-    CurrentPathIndex = 1;
-    MoveStep();
+    OccupyCell(GridManager, NewCellIndex);
 }
 
-// Calcola il percorso minimo tra due celle utilizzando la BFS
-TArray<AGridCell*> ABaseUnit::ComputePath(AGridCell* Start, AGridCell* Goal)
+// Muove l'unit lungo un percorso gi calcolato (dalla cella attuale alla destinazione, estremi inclusi)
+void ABaseUnit::MoveAlongPath(const TArray<int32>& Path)
 {
-    TArray<AGridCell*> Path;
-    if (!Start || !Goal)
-    {
-        return Path;
-    }
-
-    AGridManager* GM = AGridManager::GetInstance(GetWorld());
-    if (!GM)
+    AGridManager* GridManager = AGridManager::GetInstance(GetWorld());
+    if (!GridManager || Path.Num() < 2 || Path[0] != CurrentCellIndex)
     {
-        return Path;
+        UE_LOG(LogTemp, Warning, TEXT("Cannot move: invalid path"));
+        return;
     }
 
-    // Ottiene l'array di tutte le celle dalla GridManager
-    const TArray<AGridCell*>& AllCells = GM->GetGridCells();
-
-    // BFS per il percorso minimo
-    TQueue<AGridCell*> Frontier;
-    TMap<AGridCell*, AGridCell*> CameFrom;
-    Frontier.Enqueue(Start);
-    CameFrom.Add(Start, nullptr);
+    OccupyCell(GridManager, Path.Last());
+    StartMovement(Path);
+}
 
-    while (!Frontier.IsEmpty())
+// Arrivo del percorso richiesto da MoveToCell: avvia il movimento oppure, se il percorso non esiste, riporta l'unit indietro
+void ABaseUnit::OnMovePathReady(const TArray<int32>& Path, int32 FromCellIndex)
+{
+    if (Path.Num() == 0)
     {
-        AGridCell* Current = nullptr;
-        Frontier.Dequeue(Current);
-
-        if (Current == Goal)
-        {
-            break;
-        }
+        UE_LOG(LogTemp, Warning, TEXT("No path found to move"));
 
-        // Esplora le celle adiacenti 
-        for (AGridCell* Cell : AllCells)
+        AGridManager* GridManager = AGridManager::GetInstance(GetWorld());
+        if (GridManager && GridManager->IsWalkable(FromCellIndex))
         {
-            if (!Cell)
-            {
-                continue;
-            }
-
-            int32 ManhattanDistance = FMath::Abs(Cell->GridX - Current->GridX) + FMath::Abs(Cell->GridY - Current->GridY);
-            if (ManhattanDistance == 1)
-            {
-                // Considera la cella se non  un ostacolo e non  occupata 
-                if (!Cell->bIsObstacle && (!Cell->bIsOccupied || Cell == Goal))
-                {
-                    if (!CameFrom.Contains(Cell))
-                    {
-                        Frontier.Enqueue(Cell);
-                        CameFrom.Add(Cell, Current);
-                    }
-                }
-            }
+            OccupyCell(GridManager, FromCellIndex);
         }
+        return;
     }
 
-    if (!CameFrom.Contains(Goal))
+    // La destinazione potrebbe essere cambiata mentre la ricerca era in corso
+    if (Path.Last() == CurrentCellIndex)
     {
-        return Path;
+        StartMovement(Path);
     }
+}
 
-    AGridCell* Current = Goal;
-    while (Current)
-    {
-        Path.Insert(Current, 0);
-        Current = CameFrom.FindRef(Current);
-    }
-    return Path;
+// Libera la cella attuale e occupa quella di destinazione
+void ABaseUnit::OccupyCell(AGridManager* GridManager, int32 NewCellIndex)
+{
+    GridManager->ClearCellOccupant(CurrentCellIndex);
+    GridManager->SetCellOccupant(NewCellIndex, this);
+    CurrentCellIndex = NewCellIndex;
+}
+
+// Salva il percorso e inizia il movimento graduale
+void ABaseUnit::StartMovement(const TArray<int32>& Path)
+{
+    MovementPath = Path;
+    CurrentPathIndex = 1;
+    MoveStep();
 }
 
 // Esegue un passo del movimento lungo il percorso calcolato
@@ -298,10 +294,10 @@ void ABaseUnit::MoveStep()
 {
     if (CurrentPathIndex < MovementPath.Num())
     {
-        AGridCell* NextCell = MovementPath[CurrentPathIndex];
-        if (NextCell)
+        AGridManager* GridManager = AGridManager::GetInstance(GetWorld());
+        if (GridManager)
         {
-            FVector TargetLocation = NextCell->GetActorLocation() + FVector(0.f, 0.f, 50.f);
+            FVector TargetLocation = GridManager->GetCellLocation(MovementPath[CurrentPathIndex]) + FVector(0.f, 0.f, 50.f);
             SetActorLocation(TargetLocation);
         }
         CurrentPathIndex++;
@@ -309,16 +305,7 @@ void ABaseUnit::MoveStep()
     }
     else
     {
-        // Movimento completato: aggiorna la cella attuale
-        if (MovementPath.Num() > 0)
-        {
-            AGridCell* FinalCell = MovementPath.Last();
-            if (FinalCell)
-            {
-                FinalCell->SetOccupied(true);
-                CurrentCell = FinalCell;
-            }
-        }
+        // Movimento completato (la cella attuale  gi stata aggiornata in MoveToCell)
         bHasMoved = true;
         // Se l'unit del giocatore non ha ancora attaccato, visualizza il range aggiornato
         if (TeamType == ETeamType::Player && !bHasAttacked)
@@ -394,11 +381,10 @@ void ABaseUnit::AttackTarget(ABaseUnit* Target)
         {
             bCounterattackCondition = true;
         }
-        else if (Target->UnitType == EUnitType::Brawler && CurrentCell && Target->CurrentCell)
+        else if (Target->UnitType == EUnitType::Brawler && GameMode && GameMode->GridManager
+            && CurrentCellIndex != INDEX_NONE && Target->CurrentCellIndex != INDEX_NONE)
         {
-            int32 DeltaX = FMath::Abs(CurrentCell->GridX - Target->CurrentCell->GridX);
-            int32 DeltaY = FMath::Abs(CurrentCell->GridY - Target->CurrentCell->GridY);
-            if ((DeltaX + DeltaY) == 1)
+            if (GameMode->GridManager->GetDistance(CurrentCellIndex, Target->CurrentCellIndex) == 1)
             {
                 bCounterattackCondition = true;
             }
@@ -413,7 +399,7 @@ void ABaseUnit::AttackTarget(ABaseUnit* Target)
 
             FString UnitPrefix = (TeamType == ETeamType::Player) ? TEXT("HP: S") : TEXT("AI: S");
             // Otteniamo la cella in cui si trova l'attaccante
-            FString CellID = (GameMode) ? GameMode->GetCellIdentifier(CurrentCell) : TEXT("Unknown");
+            FString CellID = (GameMode) ? GameMode->GetCellIdentifier(CurrentCellIndex) : TEXT("Unknown");
             FString HistoryMsg = FString::Printf(TEXT("%s %s %d"), *UnitPrefix, *CellID, CounterDamage);
 
             FString CounterMsg = FString::Printf(TEXT("%s suffered a counterattack causing %d damage. Remaining health: %d"),
@@ -0,0 +1,252 @@
+#include "GridBitboard.h"
+#include "GridSearchContext.h"
+#include "GridGenerator.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+
+namespace
+{
+    // Comando da console per lanciare il benchmark: Paa.BenchmarkReachability [Size1 Size2 ...]
+    FAutoConsoleCommand ReachabilityBenchmarkCommand(
+        TEXT("Paa.BenchmarkReachability"),
+        TEXT("Compares the per-cell movement range BFS with the row bitboard flood fill. Usage: Paa.BenchmarkReachability [Size1 Size2 ...]"),
+        FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+        {
+            TArray<int32> GridSizes;
+            for (const FString& Arg : Args)
+            {
+                int32 Size = FCString::Atoi(*Arg);
+                if (Size > 0)
+                {
+                    GridSizes.Add(Size);
+                }
+            }
+            if (GridSizes.Num() == 0)
+            {
+                GridSizes = { 25, 100, 500 };
+            }
+            FGridBitboard::RunBenchmark(GridSizes, 1000, 12345);
+        }));
+}
+
+void FGridBitboard::Init(int32 InRows, int32 InColumns)
+{
+    if (InRows == Rows && InColumns == Columns)
+    {
+        Reset();
+        return;
+    }
+
+    Rows = InRows;
+    Columns = InColumns;
+    WordsPerRow = FMath::DivideAndRoundUp(Columns, 64);
+    Words.SetNumUninitialized(Rows * WordsPerRow);
+    FMemory::Memzero(Words.GetData(), Words.Num() * sizeof(uint64));
+    FirstUsedRow = Rows;
+    LastUsedRow = -1;
+}
+
+void FGridBitboard::Reset()
+{
+    if (LastUsedRow >= FirstUsedRow)
+    {
+        FMemory::Memzero(Words.GetData() + FirstUsedRow * WordsPerRow, (LastUsedRow - FirstUsedRow + 1) * WordsPerRow * sizeof(uint64));
+    }
+    FirstUsedRow = Rows;
+    LastUsedRow = -1;
+}
+
+int32 FGridBitboard::CountSetBits() const
+{
+    int32 Count = 0;
+    for (int32 Index = FirstUsedRow * WordsPerRow; Index < (LastUsedRow + 1) * WordsPerRow; Index++)
+    {
+        Count += (int32)FMath::CountBits(Words[Index]);
+    }
+    return Count;
+}
+
+void FGridBitboard::FloodFill(const FGridBitboard& Passable, int32 Origin, int32 Range, FGridBitboard& OutReached, TArray<FGridBitboard>& OutLayers)
+{
+    const int32 NumRows = Passable.Rows;
+    const int32 NumWords = Passable.WordsPerRow;
+
+    // I buffer vengono riusati tra una chiamata e l'altra finch la griglia ha le stesse dimensioni,
+    // e ognuno viene azzerato solo nelle righe scritte dalla chiamata precedente
+    OutReached.Init(NumRows, Passable.Columns);
+    if (OutLayers.Num() < Range + 1)
+    {
+        OutLayers.SetNum(Range + 1);
+    }
+    for (int32 Layer = 0; Layer <= Range; Layer++)
+    {
+        OutLayers[Layer].Init(NumRows, Passable.Columns);
+    }
+
+    const int32 OriginX = Origin % Passable.Columns;
+    const int32 OriginY = Origin / Passable.Columns;
+    OutLayers[0].Set(Origin);
+    OutReached.Set(Origin);
+
+    for (int32 Layer = 1; Layer <= Range; Layer++)
+    {
+        const TArray<uint64>& Frontier = OutLayers[Layer - 1].Words;
+        TArray<uint64>& Next = OutLayers[Layer].Words;
+
+        // Le celle a distanza Layer stanno nel rombo di raggio Layer: basta la fascia di righe e parole che lo contiene
+        const int32 MinY = FMath::Max(OriginY - Layer, 0);
+        const int32 MaxY = FMath::Min(OriginY + Layer, NumRows - 1);
+        const int32 MinWord = FMath::Max(OriginX - Layer, 0) >> 6;
+        const int32 MaxWord = FMath::Min(OriginX + Layer, Passable.Columns - 1) >> 6;
+        OutLayers[Layer].MarkRowsUsed(MinY, MaxY);
+        OutReached.MarkRowsUsed(MinY, MaxY);
+
+        bool bAnyNew = false;
+        for (int32 Y = MinY; Y <= MaxY; Y++)
+        {
+            const int32 Row = Y * NumWords;
+            for (int32 Word = MinWord; Word <= MaxWord; Word++)
+            {
+                const int32 Index = Row + Word;
+
+                // Vicini a est e ovest con il riporto dalle parole adiacenti, poi quelli sopra e sotto
+                uint64 Spread = (Frontier[Index] << 1) | (Frontier[Index] >> 1);
+                if (Word > 0)
+                {
+                    Spread |= Frontier[Index - 1] >> 63;
+                }
+                if (Word + 1 < NumWords)
+                {
+                    Spread |= Frontier[Index + 1] << 63;
+                }
+                if (Y > 0)
+                {
+                    Spread |= Frontier[Index - NumWords];
+                }
+                if (Y + 1 < NumRows)
+                {
+                    Spread |= Frontier[Index + NumWords];
+                }
+
+                const uint64 NewBits = Spread & Passable.Words[Index] & ~OutReached.Words[Index];
+                Next[Index] = NewBits;
+                OutReached.Words[Index] |= NewBits;
+                bAnyNew |= (NewBits != 0);
+            }
+        }
+
+        if (!bAnyNew)
+        {
+            break;
+        }
+    }
+
+    OutReached.Clear(Origin);
+}
+
+// Stampa nel log il tempo medio per calcolare l'area di movimento (raggi 3 e 6) con una BFS cella per cella
+// e con il riempimento a bit, sulle stesse celle di partenza, e se le due aree coincidono
+void FGridBitboard::RunBenchmark(const TArray<int32>& GridSizes, int32 QueriesPerSize, int32 Seed)
+{
+    UE_LOG(LogTemp, Warning, TEXT("Reachability benchmark, %d queries per size and range, seed %d"), QueriesPerSize, Seed);
+
+    for (int32 Size : GridSizes)
+    {
+        FRandomStream Stream(Seed);
+        TArray<bool> Obstacles;
+        FGridObstacleGenerator::Generate(EGridGeneratorType::NoiseField, Size, Size, 20.0f, Stream, Obstacles);
+
+        FGridBitboard Passable;
+        Passable.Init(Size, Size);
+        TArray<int32> FreeCells;
+        for (int32 Index = 0; Index < Obstacles.Num(); Index++)
+        {
+            if (!Obstacles[Index])
+            {
+                Passable.Set(Index);
+                FreeCells.Add(Index);
+            }
+        }
+
+        TArray<int32> Origins;
+        for (int32 i = 0; i < QueriesPerSize; i++)
+        {
+            Origins.Add(FreeCells[Stream.RandRange(0, FreeCells.Num() - 1)]);
+        }
+
+        for (int32 Range : { 3, 6 })
+        {
+            // BFS cella per cella di riferimento: OutCells riceve le celle raggiunte, esclusa la partenza
+            FGridSearchContext Context;
+            auto ReachWithBFS = [&Context, &Obstacles, Size, Range](int32 Origin, TArray<int32>& OutCells)
+            {
+                OutCells.Reset();
+                Context.BeginSearch(Size * Size);
+                Context.Visit(Origin, INDEX_NONE, 0);
+                Context.PushFrontier(Origin);
+                while (!Context.IsFrontierEmpty())
+                {
+                    const int32 Current = Context.PopFrontier();
+                    const int32 Distance = Context.GetCost(Current);
+                    if (Distance == Range)
+                    {
+                        continue;
+                    }
+                    const int32 X = Current % Size;
+                    const int32 Y = Current / Size;
+                    const int32 Neighbors[4] = {
+                        Y > 0 ? Current - Size : INDEX_NONE,
+                        X < Size - 1 ? Current + 1 : INDEX_NONE,
+                        Y < Size - 1 ? Current + Size : INDEX_NONE,
+                        X > 0 ? Current - 1 : INDEX_NONE
+                    };
+                    for (int32 Neighbor : Neighbors)
+                    {
+                        if (Neighbor != INDEX_NONE && !Obstacles[Neighbor] && !Context.IsVisited(Neighbor))
+                        {
+                            Context.Visit(Neighbor, Current, Distance + 1);
+                            Context.PushFrontier(Neighbor);
+                            OutCells.Add(Neighbor);
+                        }
+                    }
+                }
+            };
+
+            TArray<int32> BFSCells;
+            BFSCells.Reserve(Size * Size);
+            double StartTime = FPlatformTime::Seconds();
+            for (int32 Origin : Origins)
+            {
+                ReachWithBFS(Origin, BFSCells);
+            }
+            const double BFSUs = (FPlatformTime::Seconds() - StartTime) * 1000000.0 / Origins.Num();
+
+            FGridBitboard Reached;
+            TArray<FGridBitboard> Layers;
+            StartTime = FPlatformTime::Seconds();
+            for (int32 Origin : Origins)
+            {
+                FloodFill(Passable, Origin, Range, Reached, Layers);
+            }
+            const double BitboardUs = (FPlatformTime::Seconds() - StartTime) * 1000000.0 / Origins.Num();
+
+            // Verifica fuori dal tempo misurato: per ogni query le due aree devono avere le stesse celle
+            int32 Mismatches = 0;
+            for (int32 Origin : Origins)
+            {
+                ReachWithBFS(Origin, BFSCells);
+                FloodFill(Passable, Origin, Range, Reached, Layers);
+                bool bSame = (Reached.CountSetBits() == BFSCells.Num());
+                for (int32 Index = 0; Index < BFSCells.Num() && bSame; Index++)
+                {
+                    bSame = Reached.Test(BFSCells[Index]);
+                }
+                Mismatches += bSame ? 0 : 1;
+            }
+
+            UE_LOG(LogTemp, Warning, TEXT("%dx%d range %d: per-cell BFS %.2f us/query, bitboard %.2f us/query, same areas: %s (%d of %d queries differ)"),
+                Size, Size, Range, BFSUs, BitboardUs, Mismatches == 0 ? TEXT("yes") : TEXT("no"), Mismatches, Origins.Num());
+        }
+    }
+}
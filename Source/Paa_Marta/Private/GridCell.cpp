@@ -4,6 +4,7 @@
 #include "BaseUnit.h"
 #include "Kismet/GameplayStatics.h"
 #include "MyGameMode.h"
+#include "GridManager.h"
 
 // Costruttore della classe AGridCell: inizializza i componenti base della cella e imposta le propriet predefinite
 AGridCell::AGridCell()
@@ -27,11 +28,10 @@ AGridCell::AGridCell()
     MeshComponent->SetCustomDepthStencilValue(1);
 
     // Inizializza le propriet della cella
-    bIsOccupied = false;
-    bIsObstacle = false;
-    OccupyingUnit = nullptr;
     GridX = 0;
     GridY = 0;
+    CellIndex = INDEX_NONE;
+    BaseMaterial = nullptr;
 
     InfoBox = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("InfoBox"));
     InfoBox->SetupAttachment(RootComponent);
@@ -84,37 +84,23 @@ void AGridCell::InitializeCell(bool bIsAnObstacle, const FVector& CellSize, UMat
 {
     NormalMaterial = InNormalMaterial;
     ObstacleMaterial = InObstacleMaterial;  
-    bIsObstacle = bIsAnObstacle;
 
     FVector MeshScale = CellSize / 100.f;
     MeshComponent->SetWorldScale3D(MeshScale);
 
-    if (bIsObstacle)
+    // I materiali sono condivisi da tutte le celle: l'evidenziazione viene dalla texture del GridManager
+    BaseMaterial = bIsAnObstacle ? InObstacleMaterial : InNormalMaterial;
+    if (BaseMaterial)
     {
-        if (InObstacleMaterial)
-        {
-            MeshComponent->SetMaterial(0, InObstacleMaterial);  
-        }
+        MeshComponent->SetMaterial(0, BaseMaterial);  
     }
-    else
-    {
-        if (InNormalMaterial)
-        {
-            MeshComponent->SetMaterial(0, InNormalMaterial);  
-        }
-    }
-}
-
-// Imposta lo stato di occupazione della cella
-void AGridCell::SetOccupied(bool bOccupied)
-{
-    bIsOccupied = bOccupied;
 }
 
 // Funzione chiamata al click della cella
 void AGridCell::OnCellClicked()
 {
-    if (bIsObstacle || bIsOccupied)
+    AGridManager* GridManager = AGridManager::GetInstance(GetWorld());
+    if (!GridManager || !GridManager->IsValidCell(CellIndex) || !GridManager->IsWalkable(CellIndex))
     {
         return;
     }
@@ -122,7 +108,7 @@ void AGridCell::OnCellClicked()
     AMyGameMode* GameMode = Cast<AMyGameMode>(UGameplayStatics::GetGameMode(GetWorld()));
     if (GameMode)
     {
-        GameMode->OnGridCellClicked(this);
+        GameMode->OnGridCellClicked(CellIndex);
     }
 }
 
@@ -139,15 +125,8 @@ void AGridCell::HighlightCell(const FLinearColor& Color)
 
 void AGridCell::ResetHighlight()
 {
-    if (MeshComponent)
+    if (MeshComponent && BaseMaterial)
     {
-        if (bIsObstacle && ObstacleMaterial)
-        {
-            MeshComponent->SetMaterial(0, ObstacleMaterial);
-        }
-        else if (NormalMaterial)
-        {
-            MeshComponent->SetMaterial(0, NormalMaterial);
-        }
+        MeshComponent->SetMaterial(0, BaseMaterial);
     }
 }
@@ -0,0 +1,175 @@
+#include "GridDistanceTable.h"
+#include "GridGenerator.h"
+#include "Async/ParallelFor.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+
+namespace
+{
+    // Numero massimo di gruppi di partenze in cui viene divisa la costruzione (ognuno riusa la propria frontiera)
+    constexpr int32 MaxBuildBatches = 64;
+
+    // Comando da console per lanciare il benchmark: Paa.BenchmarkDistanceTable [Size1 Size2 ...]
+    FAutoConsoleCommand DistanceTableBenchmarkCommand(
+        TEXT("Paa.BenchmarkDistanceTable"),
+        TEXT("Measures all-pairs distance table build time and memory. Usage: Paa.BenchmarkDistanceTable [Size1 Size2 ...]"),
+        FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+        {
+            TArray<int32> GridSizes;
+            for (const FString& Arg : Args)
+            {
+                int32 Size = FCString::Atoi(*Arg);
+                if (Size > 0)
+                {
+                    GridSizes.Add(Size);
+                }
+            }
+            if (GridSizes.Num() == 0)
+            {
+                GridSizes = { 25, 48, 64 };
+            }
+            FGridDistanceTable::RunBenchmark(GridSizes, 20.0f, 12345);
+        }));
+}
+
+void FGridDistanceTable::Build(int32 InRows, int32 InColumns, const TArray<bool>& Obstacles)
+{
+    Rows = InRows;
+    Columns = InColumns;
+    const int32 TotalCells = Rows * Columns;
+
+    FreeIndex.Init(INDEX_NONE, TotalCells);
+    FreeCells.Reset();
+    for (int32 Cell = 0; Cell < TotalCells; Cell++)
+    {
+        if (!Obstacles[Cell])
+        {
+            FreeIndex[Cell] = FreeCells.Add(Cell);
+        }
+    }
+    NumFreeCells = FreeCells.Num();
+
+    // Le distanze devono stare in 16 bit (la pi lunga possibile  minore del numero di celle libere)
+    // e la tabella in un solo array
+    check(NumFreeCells < Unreachable && (int64)NumFreeCells * NumFreeCells <= MAX_int32);
+    Distances.Init(Unreachable, NumFreeCells * NumFreeCells);
+
+    // Ogni BFS scrive solo la propria riga, quindi i gruppi di partenze possono lavorare in parallelo
+    const int32 NumBatches = FMath::Min(NumFreeCells, MaxBuildBatches);
+    ParallelFor(NumBatches, [this, NumBatches](int32 Batch)
+    {
+        TArray<int32> Frontier;
+        Frontier.Reserve(NumFreeCells);
+
+        for (int32 Source = Batch; Source < NumFreeCells; Source += NumBatches)
+        {
+            uint16* Row = Distances.GetData() + Source * NumFreeCells;
+            Frontier.Reset();
+            Frontier.Add(FreeCells[Source]);
+            Row[Source] = 0;
+
+            for (int32 Head = 0; Head < Frontier.Num(); Head++)
+            {
+                const int32 Current = Frontier[Head];
+                const uint16 NextDistance = Row[FreeIndex[Current]] + 1;
+                const int32 CurrentX = Current % Columns;
+                const int32 CurrentY = Current / Columns;
+
+                const int32 Neighbors[4] = {
+                    CurrentY > 0 ? Current - Columns : INDEX_NONE,
+                    CurrentX < Columns - 1 ? Current + 1 : INDEX_NONE,
+                    CurrentY < Rows - 1 ? Current + Columns : INDEX_NONE,
+                    CurrentX > 0 ? Current - 1 : INDEX_NONE
+                };
+
+                for (int32 Neighbor : Neighbors)
+                {
+                    if (Neighbor == INDEX_NONE)
+                    {
+                        continue;
+                    }
+                    const int32 NeighborFree = FreeIndex[Neighbor];
+                    if (NeighborFree != INDEX_NONE && Row[NeighborFree] == Unreachable)
+                    {
+                        Row[NeighborFree] = NextDistance;
+                        Frontier.Add(Neighbor);
+                    }
+                }
+            }
+        }
+    });
+}
+
+int32 FGridDistanceTable::GetNextStep(int32 From, int32 To) const
+{
+    const int32 Distance = GetDistance(From, To);
+    if (Distance == INDEX_NONE || Distance == 0)
+    {
+        return INDEX_NONE;
+    }
+
+    // Le distanze sono simmetriche: si legge la riga di To, che resta in cache per tutti i passi del percorso
+    const uint16* Row = Distances.GetData() + FreeIndex[To] * NumFreeCells;
+    const int32 FromX = From % Columns;
+    const int32 FromY = From / Columns;
+
+    const int32 Neighbors[4] = {
+        FromY > 0 ? From - Columns : INDEX_NONE,
+        FromX < Columns - 1 ? From + 1 : INDEX_NONE,
+        FromY < Rows - 1 ? From + Columns : INDEX_NONE,
+        FromX > 0 ? From - 1 : INDEX_NONE
+    };
+
+    for (int32 Neighbor : Neighbors)
+    {
+        if (Neighbor != INDEX_NONE && FreeIndex[Neighbor] != INDEX_NONE && Row[FreeIndex[Neighbor]] == Distance - 1)
+        {
+            return Neighbor;
+        }
+    }
+    return INDEX_NONE;
+}
+
+bool FGridDistanceTable::GetPath(int32 From, int32 To, TArray<int32>& OutPath) const
+{
+    OutPath.Reset();
+    const int32 Distance = GetDistance(From, To);
+    if (Distance == INDEX_NONE)
+    {
+        return false;
+    }
+
+    OutPath.Reserve(Distance + 1);
+    for (int32 Cell = From; Cell != INDEX_NONE; Cell = GetNextStep(Cell, To))
+    {
+        OutPath.Add(Cell);
+    }
+    return true;
+}
+
+SIZE_T FGridDistanceTable::GetAllocatedSize() const
+{
+    return Distances.GetAllocatedSize() + FreeIndex.GetAllocatedSize() + FreeCells.GetAllocatedSize();
+}
+
+// Costruisce la tabella su mappe generate con il seed indicato e stampa tempo e memoria
+void FGridDistanceTable::RunBenchmark(const TArray<int32>& GridSizes, float ObstaclePercentage, int32 Seed)
+{
+    UE_LOG(LogTemp, Warning, TEXT("Distance table benchmark, %.0f%% obstacles, seed %d"), ObstaclePercentage, Seed);
+
+    for (int32 Size : GridSizes)
+    {
+        FRandomStream Stream(Seed);
+        TArray<bool> Obstacles;
+        FGridObstacleGenerator::GenerateObstacles(Size, Size, ObstaclePercentage, Stream, Obstacles);
+
+        FGridDistanceTable Table;
+        const double StartTime = FPlatformTime::Seconds();
+        Table.Build(Size, Size, Obstacles);
+        const double BuildMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+        UE_LOG(LogTemp, Warning, TEXT("%dx%d: %d free cells, built in %.2f ms, %.2f MB"),
+            Size, Size, Table.GetNumFreeCells(), BuildMs, Table.GetAllocatedSize() / (1024.0 * 1024.0));
+    }
+}
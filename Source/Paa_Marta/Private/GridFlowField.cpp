@@ -0,0 +1,47 @@
+#include "GridFlowField.h"
+#include "GridSearchContext.h"
+
+// BFS a partire dall'obiettivo: ogni cella raggiunta punta alla cella da cui  stata scoperta,
+// che  un passo pi vicina all'obiettivo
+void FGridFlowField::Build(int32 Rows, int32 Columns, const TArray<bool>& Obstacles, int32 Target, FGridSearchContext& Context)
+{
+    const int32 TotalCells = Rows * Columns;
+    TargetCell = Target;
+    Distance.Init(INDEX_NONE, TotalCells);
+    NextCell.Init(INDEX_NONE, TotalCells);
+
+    if (Target < 0 || Target >= TotalCells)
+    {
+        return;
+    }
+
+    // Le distanze fanno gi da insieme dei visitati: del contesto serve solo la frontiera
+    Context.BeginSearch(TotalCells);
+    Context.PushFrontier(Target);
+    Distance[Target] = 0;
+
+    while (!Context.IsFrontierEmpty())
+    {
+        const int32 Current = Context.PopFrontier();
+        const int32 CurrentX = Current % Columns;
+        const int32 CurrentY = Current / Columns;
+        const int32 NextDistance = Distance[Current] + 1;
+
+        const int32 Neighbors[4] = {
+            CurrentY > 0 ? Current - Columns : INDEX_NONE,
+            CurrentX < Columns - 1 ? Current + 1 : INDEX_NONE,
+            CurrentY < Rows - 1 ? Current + Columns : INDEX_NONE,
+            CurrentX > 0 ? Current - 1 : INDEX_NONE
+        };
+
+        for (int32 Neighbor : Neighbors)
+        {
+            if (Neighbor != INDEX_NONE && !Obstacles[Neighbor] && Distance[Neighbor] == INDEX_NONE)
+            {
+                Distance[Neighbor] = NextDistance;
+                NextCell[Neighbor] = Current;
+                Context.PushFrontier(Neighbor);
+            }
+        }
+    }
+}
@@ -0,0 +1,821 @@
+#include "GridGenerator.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Math/UnrealMathUtility.h"
+#include "Math/RandomStream.h"
+#include "Async/ParallelFor.h"
+
+namespace
+{
+    // Direzioni dei 4 vicini ortogonali
+    const int32 DirX[] = { 0, 1, 0, -1 };
+    const int32 DirY[] = { -1, 0, 1, 0 };
+
+    // Anello delle 8 celle attorno a una cella, in ordine: N, NE, E, SE, S, SW, W, NW (indici pari = ortogonali)
+    const int32 RingX[] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+    const int32 RingY[] = { -1, -1, 0, 1, 1, 1, 0, -1 };
+
+    // Crea la lista di tutte le posizioni della griglia in ordine casuale (Fisher-Yates guidato dallo stream)
+    void BuildShuffledPositions(int32 TotalCells, FRandomStream& Stream, TArray<int32>& OutPositions)
+    {
+        OutPositions.SetNumUninitialized(TotalCells);
+        for (int32 i = 0; i < TotalCells; i++)
+        {
+            OutPositions[i] = i;
+        }
+
+        for (int32 i = 0; i < TotalCells; i++)
+        {
+            int32 SwapIndex = Stream.RandRange(i, TotalCells - 1);
+            if (i != SwapIndex)
+            {
+                OutPositions.Swap(i, SwapIndex);
+            }
+        }
+    }
+
+    // Pesi del punteggio delle mappe: raggiungere la percentuale di ostacoli richiesta conta pi di tutto,
+    // poi si preferiscono mappe con pochi corridoi obbligati e senza grandi zone completamente vuote
+    const float ObstacleRatioWeight = 100.f;
+    const float ChokepointWeight = 50.f;
+    const float OpenAreaWeight = 25.f;
+
+    // Passate di sfocatura del campo di rumore: pi passate danno gruppi di ostacoli pi grandi
+    const int32 NoiseBlurPasses = 2;
+
+    // Numero di intervalli dell'istogramma usato per trovare la soglia del campo di rumore
+    const int32 NoiseHistogramBins = 1024;
+
+    // Sfocatura a box di raggio 1 lungo le righe (Stride = 1) o le colonne (Stride = Columns), con i bordi
+    // normalizzati sul numero di celle effettivamente sommate. Il ciclo interno  su dati contigui
+    void BoxBlurRows(int32 Rows, int32 Columns, const TArray<float>& In, TArray<float>& Out)
+    {
+        for (int32 Y = 0; Y < Rows; Y++)
+        {
+            const float* Src = In.GetData() + Y * Columns;
+            float* Dst = Out.GetData() + Y * Columns;
+            for (int32 X = 0; X < Columns; X++)
+            {
+                const float Left = X > 0 ? Src[X - 1] : 0.f;
+                const float Right = X < Columns - 1 ? Src[X + 1] : 0.f;
+                const float Count = 1.f + (X > 0 ? 1.f : 0.f) + (X < Columns - 1 ? 1.f : 0.f);
+                Dst[X] = (Left + Src[X] + Right) / Count;
+            }
+        }
+    }
+
+    void BoxBlurColumns(int32 Rows, int32 Columns, const TArray<float>& In, TArray<float>& Out)
+    {
+        for (int32 Y = 0; Y < Rows; Y++)
+        {
+            const float* Up = In.GetData() + FMath::Max(Y - 1, 0) * Columns;
+            const float* Src = In.GetData() + Y * Columns;
+            const float* Down = In.GetData() + FMath::Min(Y + 1, Rows - 1) * Columns;
+            const float UpWeight = Y > 0 ? 1.f : 0.f;
+            const float DownWeight = Y < Rows - 1 ? 1.f : 0.f;
+            const float InvCount = 1.f / (1.f + UpWeight + DownWeight);
+            float* Dst = Out.GetData() + Y * Columns;
+            for (int32 X = 0; X < Columns; X++)
+            {
+                Dst[X] = (UpWeight * Up[X] + Src[X] + DownWeight * Down[X]) * InvCount;
+            }
+        }
+    }
+
+    // Numero di mappe candidate generate dal benchmark
+    const int32 BenchmarkCandidates = 8;
+
+    // Seed fisso del benchmark, cos ogni build viene misurata sulle stesse mappe
+    const int32 BenchmarkSeed = 12345;
+
+    // Comando da console per lanciare il benchmark: Paa.BenchmarkGridGeneration [Size1 Size2 ...]
+    FAutoConsoleCommand GridGenerationBenchmarkCommand(
+        TEXT("Paa.BenchmarkGridGeneration"),
+        TEXT("Logs obstacle generation time against grid size. Usage: Paa.BenchmarkGridGeneration [Size1 Size2 ...]"),
+        FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+        {
+            TArray<int32> GridSizes;
+            for (const FString& Arg : Args)
+            {
+                int32 Size = FCString::Atoi(*Arg);
+                if (Size > 0)
+                {
+                    GridSizes.Add(Size);
+                }
+            }
+            if (GridSizes.Num() == 0)
+            {
+                GridSizes = { 25, 50, 100, 200, 400 };
+            }
+            FGridObstacleGenerator::RunBenchmark(GridSizes, 20.0f, BenchmarkSeed);
+        }));
+}
+
+// Genera gli ostacoli controllando la connettivit in modo incrementale:
+// la griglia parte completamente libera (quindi connessa) e ogni ostacolo viene accettato solo se non separa
+// i suoi vicini liberi. Nella maggior parte dei casi basta il test locale sulle 8 celle attorno, la ricerca
+// di fallback viene usata solo quando i vicini non sono collegati localmente
+int32 FGridObstacleGenerator::GenerateObstacles(int32 Rows, int32 Columns, float ObstaclePercentage, FRandomStream& Stream, TArray<bool>& OutObstacles)
+{
+    const int32 TotalCells = Rows * Columns;
+    OutObstacles.Init(false, TotalCells);
+    if (TotalCells <= 0)
+    {
+        return 0;
+    }
+
+    const int32 MaxObstacles = FMath::RoundToInt(TotalCells * (ObstaclePercentage / 100.0f));
+    int32 PlacedObstacles = 0;
+    int32 FreeCells = TotalCells;
+
+    TArray<int32> AllPositions;
+    BuildShuffledPositions(TotalCells, Stream, AllPositions);
+
+    FFallbackScratch Scratch;
+    Scratch.VisitStamp.Init(0, TotalCells);
+    Scratch.Owner.SetNumZeroed(TotalCells);
+
+    for (int32 Index : AllPositions)
+    {
+        // L'ultima cella libera non pu diventare un ostacolo
+        if (PlacedObstacles >= MaxObstacles || FreeCells <= 1)
+        {
+            break;
+        }
+
+        const int32 X = Index % Columns;
+        const int32 Y = Index / Columns;
+
+        bool bKeepsConnected = IsLocallySafe(Rows, Columns, OutObstacles, X, Y);
+        if (!bKeepsConnected)
+        {
+            bKeepsConnected = AreNeighborsConnected(Rows, Columns, OutObstacles, X, Y, Scratch);
+        }
+
+        if (bKeepsConnected)
+        {
+            OutObstacles[Index] = true;
+            PlacedObstacles++;
+            FreeCells--;
+        }
+    }
+
+    return PlacedObstacles;
+}
+
+bool FGridObstacleGenerator::IsLocallySafe(int32 Rows, int32 Columns, const TArray<bool>& Obstacles, int32 X, int32 Y)
+{
+    bool bFree[8];
+    int32 FirstBlocked = INDEX_NONE;
+    for (int32 k = 0; k < 8; k++)
+    {
+        const int32 NewX = X + RingX[k];
+        const int32 NewY = Y + RingY[k];
+        bFree[k] = NewX >= 0 && NewX < Columns && NewY >= 0 && NewY < Rows && !Obstacles[NewY * Columns + NewX];
+        if (!bFree[k] && FirstBlocked == INDEX_NONE)
+        {
+            FirstBlocked = k;
+        }
+    }
+
+    // Anello completamente libero: tutti i vicini restano connessi
+    if (FirstBlocked == INDEX_NONE)
+    {
+        return true;
+    }
+
+    // Celle consecutive dell'anello sono adiacenti, quindi ogni tratto libero  un gruppo connesso.
+    // Conta i tratti che contengono almeno un vicino ortogonale, partendo da una cella bloccata
+    int32 Groups = 0;
+    bool bInRun = false;
+    bool bRunHasOrthogonal = false;
+    for (int32 Step = 1; Step <= 8; Step++)
+    {
+        const int32 k = (FirstBlocked + Step) % 8;
+        if (bFree[k])
+        {
+            bInRun = true;
+            bRunHasOrthogonal |= (k % 2 == 0);
+        }
+        else
+        {
+            if (bInRun && bRunHasOrthogonal)
+            {
+                Groups++;
+            }
+            bInRun = false;
+            bRunHasOrthogonal = false;
+        }
+    }
+
+    return Groups <= 1;
+}
+
+bool FGridObstacleGenerator::AreNeighborsConnected(int32 Rows, int32 Columns, const TArray<bool>& Obstacles, int32 X, int32 Y, FFallbackScratch& Scratch)
+{
+    const int32 Blocked = Y * Columns + X;
+
+    int32 Targets[4];
+    int32 NumTargets = 0;
+    for (int32 Dir = 0; Dir < 4; Dir++)
+    {
+        const int32 NewX = X + DirX[Dir];
+        const int32 NewY = Y + DirY[Dir];
+        if (NewX >= 0 && NewX < Columns && NewY >= 0 && NewY < Rows && !Obstacles[NewY * Columns + NewX])
+        {
+            Targets[NumTargets++] = NewY * Columns + NewX;
+        }
+    }
+
+    if (NumTargets <= 1)
+    {
+        return true;
+    }
+
+    // Nuovo timbro di visita: evita di azzerare l'array ad ogni ricerca
+    if (++Scratch.Stamp == 0)
+    {
+        Scratch.VisitStamp.Init(0, Scratch.VisitStamp.Num());
+        Scratch.Stamp = 1;
+    }
+    const uint32 Stamp = Scratch.Stamp;
+
+    // Union-find sui gruppi di ricerca: due ricerche che si incontrano diventano lo stesso gruppo
+    int32 Parent[4];
+    int32 Heads[4];
+    for (int32 t = 0; t < NumTargets; t++)
+    {
+        Parent[t] = t;
+        Heads[t] = 0;
+        Scratch.Queues[t].Reset();
+        Scratch.Queues[t].Add(Targets[t]);
+        Scratch.VisitStamp[Targets[t]] = Stamp;
+        Scratch.Owner[Targets[t]] = static_cast<uint8>(t);
+    }
+    int32 Groups = NumTargets;
+
+    auto FindRoot = [&Parent](int32 Search)
+    {
+        while (Parent[Search] != Search)
+        {
+            Search = Parent[Search];
+        }
+        return Search;
+    };
+
+    while (true)
+    {
+        // Espande un nodo per ogni ricerca ancora attiva
+        for (int32 t = 0; t < NumTargets; t++)
+        {
+            TArray<int32>& Queue = Scratch.Queues[t];
+            if (Heads[t] >= Queue.Num())
+            {
+                continue;
+            }
+
+            const int32 Current = Queue[Heads[t]++];
+            const int32 CurrentX = Current % Columns;
+            const int32 CurrentY = Current / Columns;
+
+            for (int32 Dir = 0; Dir < 4; Dir++)
+            {
+                const int32 NewX = CurrentX + DirX[Dir];
+                const int32 NewY = CurrentY + DirY[Dir];
+                if (NewX < 0 || NewX >= Columns || NewY < 0 || NewY >= Rows)
+                {
+                    continue;
+                }
+
+                const int32 Neighbor = NewY * Columns + NewX;
+                if (Neighbor == Blocked || Obstacles[Neighbor])
+                {
+                    continue;
+                }
+
+                if (Scratch.VisitStamp[Neighbor] != Stamp)
+                {
+                    Scratch.VisitStamp[Neighbor] = Stamp;
+                    Scratch.Owner[Neighbor] = static_cast<uint8>(t);
+                    Queue.Add(Neighbor);
+                }
+                else
+                {
+                    const int32 RootA = FindRoot(t);
+                    const int32 RootB = FindRoot(Scratch.Owner[Neighbor]);
+                    if (RootA != RootB)
+                    {
+                        Parent[RootB] = RootA;
+                        if (--Groups == 1)
+                        {
+                            return true;
+                        }
+                    }
+                }
+            }
+        }
+
+        // Un gruppo le cui ricerche hanno tutte esaurito la frontiera  un'isola
+        bool bGroupAlive[4] = { false, false, false, false };
+        for (int32 t = 0; t < NumTargets; t++)
+        {
+            if (Heads[t] < Scratch.Queues[t].Num())
+            {
+                bGroupAlive[FindRoot(t)] = true;
+            }
+        }
+        for (int32 t = 0; t < NumTargets; t++)
+        {
+            if (FindRoot(t) == t && !bGroupAlive[t])
+            {
+                return false;
+            }
+        }
+    }
+}
+
+int32 FGridObstacleGenerator::Generate(EGridGeneratorType Type, int32 Rows, int32 Columns, float ObstaclePercentage, FRandomStream& Stream, TArray<bool>& OutObstacles)
+{
+    switch (Type)
+    {
+    case EGridGeneratorType::NoiseField:
+        return GenerateNoiseObstacles(Rows, Columns, ObstaclePercentage, Stream, OutObstacles);
+    default:
+        return GenerateObstacles(Rows, Columns, ObstaclePercentage, Stream, OutObstacles);
+    }
+}
+
+// Genera un campo di valori casuali, lo leviga con alcune passate di sfocatura (cos gli ostacoli formano gruppi
+// invece di celle sparse) e marca come ostacoli le celle con il valore pi alto. La soglia viene trovata con un
+// istogramma, quindi non serve ordinare le celle
+int32 FGridObstacleGenerator::GenerateNoiseObstacles(int32 Rows, int32 Columns, float ObstaclePercentage, FRandomStream& Stream, TArray<bool>& OutObstacles)
+{
+    const int32 TotalCells = Rows * Columns;
+    OutObstacles.Init(false, TotalCells);
+    if (TotalCells <= 0)
+    {
+        return 0;
+    }
+
+    // Almeno una cella deve restare libera
+    const int32 MaxObstacles = FMath::Min(FMath::RoundToInt(TotalCells * (ObstaclePercentage / 100.0f)), TotalCells - 1);
+    if (MaxObstacles <= 0)
+    {
+        return 0;
+    }
+
+    TArray<float> Field;
+    Field.SetNumUninitialized(TotalCells);
+    for (int32 Index = 0; Index < TotalCells; Index++)
+    {
+        Field[Index] = Stream.GetFraction();
+    }
+
+    TArray<float> Temp;
+    Temp.SetNumUninitialized(TotalCells);
+    for (int32 Pass = 0; Pass < NoiseBlurPasses; Pass++)
+    {
+        BoxBlurRows(Rows, Columns, Field, Temp);
+        BoxBlurColumns(Rows, Columns, Temp, Field);
+    }
+
+    // Istogramma dei valori del campo tra il minimo e il massimo
+    float MinValue = Field[0];
+    float MaxValue = Field[0];
+    for (float Value : Field)
+    {
+        MinValue = FMath::Min(MinValue, Value);
+        MaxValue = FMath::Max(MaxValue, Value);
+    }
+
+    const float BinScale = (MaxValue > MinValue) ? (NoiseHistogramBins - 1) / (MaxValue - MinValue) : 0.f;
+    TArray<int32> Bins;
+    Bins.SetNumZeroed(NoiseHistogramBins);
+    TArray<uint16> CellBins;
+    CellBins.SetNumUninitialized(TotalCells);
+    for (int32 Index = 0; Index < TotalCells; Index++)
+    {
+        const int32 Bin = FMath::TruncToInt((Field[Index] - MinValue) * BinScale);
+        CellBins[Index] = static_cast<uint16>(Bin);
+        Bins[Bin]++;
+    }
+
+    // Intervallo di soglia: tutte le celle negli intervalli superiori diventano ostacoli, quelle dell'intervallo
+    // di soglia solo fino a raggiungere esattamente MaxObstacles
+    int32 ThresholdBin = NoiseHistogramBins - 1;
+    int32 AboveThreshold = 0;
+    while (ThresholdBin > 0 && AboveThreshold + Bins[ThresholdBin] < MaxObstacles)
+    {
+        AboveThreshold += Bins[ThresholdBin];
+        ThresholdBin--;
+    }
+
+    int32 ThresholdBudget = MaxObstacles - AboveThreshold;
+    int32 PlacedObstacles = 0;
+    for (int32 Index = 0; Index < TotalCells; Index++)
+    {
+        const int32 Bin = CellBins[Index];
+        if (Bin > ThresholdBin || (Bin == ThresholdBin && ThresholdBudget-- > 0))
+        {
+            OutObstacles[Index] = true;
+            PlacedObstacles++;
+        }
+    }
+
+    return PlacedObstacles - RepairConnectivity(Rows, Columns, OutObstacles);
+}
+
+// Le zone libere vengono etichettate con una BFS. Poi una BFS 0-1 parte dalla zona pi grande: entrare in una cella
+// libera costa 0, entrare in un ostacolo costa 1. Quando la ricerca raggiunge per la prima volta una zona non ancora
+// collegata, gli ostacoli sul percorso che l'ha raggiunta vengono rimossi; la zona poi si espande a costo 0 come
+// le altre. Ogni cella viene elaborata una sola volta
+int32 FGridObstacleGenerator::RepairConnectivity(int32 Rows, int32 Columns, TArray<bool>& Obstacles)
+{
+    const int32 TotalCells = Rows * Columns;
+
+    TArray<int32> Component;
+    Component.Init(INDEX_NONE, TotalCells);
+    TArray<int32> ComponentSizes;
+    TArray<int32> Queue;
+    Queue.Reserve(TotalCells);
+
+    for (int32 Start = 0; Start < TotalCells; Start++)
+    {
+        if (Obstacles[Start] || Component[Start] != INDEX_NONE)
+        {
+            continue;
+        }
+
+        const int32 ComponentIndex = ComponentSizes.Add(0);
+        Queue.Reset();
+        Queue.Add(Start);
+        Component[Start] = ComponentIndex;
+
+        for (int32 Head = 0; Head < Queue.Num(); Head++)
+        {
+            const int32 Current = Queue[Head];
+            const int32 CurrentX = Current % Columns;
+            const int32 CurrentY = Current / Columns;
+
+            for (int32 Dir = 0; Dir < 4; Dir++)
+            {
+                const int32 NewX = CurrentX + DirX[Dir];
+                const int32 NewY = CurrentY + DirY[Dir];
+                if (NewX >= 0 && NewX < Columns && NewY >= 0 && NewY < Rows)
+                {
+                    const int32 Neighbor = NewY * Columns + NewX;
+                    if (!Obstacles[Neighbor] && Component[Neighbor] == INDEX_NONE)
+                    {
+                        Component[Neighbor] = ComponentIndex;
+                        Queue.Add(Neighbor);
+                    }
+                }
+            }
+        }
+        ComponentSizes[ComponentIndex] = Queue.Num();
+    }
+
+    if (ComponentSizes.Num() <= 1)
+    {
+        return 0;
+    }
+
+    int32 MainComponent = 0;
+    for (int32 i = 1; i < ComponentSizes.Num(); i++)
+    {
+        if (ComponentSizes[i] > ComponentSizes[MainComponent])
+        {
+            MainComponent = i;
+        }
+    }
+
+    TArray<bool> Connected;
+    Connected.Init(false, ComponentSizes.Num());
+    Connected[MainComponent] = true;
+    int32 RemainingComponents = ComponentSizes.Num() - 1;
+
+    TArray<int32> Parent;
+    Parent.Init(INDEX_NONE, TotalCells);
+    TArray<bool> Done;
+    Done.Init(false, TotalCells);
+    TArray<int32> Distance;
+    Distance.Init(MAX_int32, TotalCells);
+
+    // BFS 0-1 a due livelli: Current contiene le celle a distanza D, Next quelle a distanza D + 1
+    TArray<int32> Current;
+    TArray<int32> Next;
+    for (int32 Index = 0; Index < TotalCells; Index++)
+    {
+        if (Component[Index] == MainComponent)
+        {
+            Distance[Index] = 0;
+            Current.Add(Index);
+        }
+    }
+
+    int32 RemovedObstacles = 0;
+    while (RemainingComponents > 0 && (Current.Num() > 0 || Next.Num() > 0))
+    {
+        if (Current.Num() == 0)
+        {
+            Swap(Current, Next);
+        }
+
+        for (int32 Head = 0; Head < Current.Num() && RemainingComponents > 0; Head++)
+        {
+            const int32 Cell = Current[Head];
+            if (Done[Cell])
+            {
+                continue;
+            }
+            Done[Cell] = true;
+
+            // Prima cella raggiunta di una zona isolata: scava il corridoio fino alla zona gi collegata
+            const int32 CellComponent = Component[Cell];
+            if (CellComponent != INDEX_NONE && !Connected[CellComponent])
+            {
+                Connected[CellComponent] = true;
+                RemainingComponents--;
+                for (int32 PathCell = Parent[Cell]; PathCell != INDEX_NONE && Obstacles[PathCell]; PathCell = Parent[PathCell])
+                {
+                    Obstacles[PathCell] = false;
+                    RemovedObstacles++;
+                }
+            }
+
+            const int32 CellX = Cell % Columns;
+            const int32 CellY = Cell / Columns;
+            for (int32 Dir = 0; Dir < 4; Dir++)
+            {
+                const int32 NewX = CellX + DirX[Dir];
+                const int32 NewY = CellY + DirY[Dir];
+                if (NewX < 0 || NewX >= Columns || NewY < 0 || NewY >= Rows)
+                {
+                    continue;
+                }
+
+                const int32 Neighbor = NewY * Columns + NewX;
+                const int32 Cost = Obstacles[Neighbor] ? 1 : 0;
+                if (!Done[Neighbor] && Distance[Cell] + Cost < Distance[Neighbor])
+                {
+                    Distance[Neighbor] = Distance[Cell] + Cost;
+                    Parent[Neighbor] = Cell;
+                    (Cost == 0 ? Current : Next).Add(Neighbor);
+                }
+            }
+        }
+        Current.Reset();
+    }
+
+    return RemovedObstacles;
+}
+
+int32 FGridObstacleGenerator::GenerateBestObstacles(EGridGeneratorType Type, int32 Rows, int32 Columns, float ObstaclePercentage, int32 NumCandidates, FRandomStream& Stream,
+    TArray<bool>& OutObstacles, FGridMapScore& OutScore)
+{
+    NumCandidates = FMath::Max(NumCandidates, 1);
+
+    // I seed delle candidate vengono estratti prima di partire, cos ogni candidata  riproducibile
+    TArray<int32> SubSeeds;
+    for (int32 i = 0; i < NumCandidates; i++)
+    {
+        SubSeeds.Add(Stream.RandRange(1, MAX_int32 - 1));
+    }
+
+    TArray<TArray<bool>> Candidates;
+    Candidates.SetNum(NumCandidates);
+    TArray<int32> PlacedObstacles;
+    PlacedObstacles.SetNumZeroed(NumCandidates);
+    TArray<FGridMapScore> Scores;
+    Scores.SetNum(NumCandidates);
+
+    // Ogni candidata usa solo i propri dati, quindi possono essere generate in parallelo
+    ParallelFor(NumCandidates, [&](int32 CandidateIndex)
+    {
+        FRandomStream CandidateStream(SubSeeds[CandidateIndex]);
+        PlacedObstacles[CandidateIndex] = Generate(Type, Rows, Columns, ObstaclePercentage, CandidateStream, Candidates[CandidateIndex]);
+        Scores[CandidateIndex] = ScoreMap(Rows, Columns, ObstaclePercentage, Candidates[CandidateIndex]);
+    });
+
+    // A parit di punteggio vince la candidata con indice pi basso
+    int32 BestIndex = 0;
+    for (int32 i = 1; i < NumCandidates; i++)
+    {
+        if (Scores[i].Total > Scores[BestIndex].Total)
+        {
+            BestIndex = i;
+        }
+    }
+
+    OutObstacles = MoveTemp(Candidates[BestIndex]);
+    OutScore = Scores[BestIndex];
+    return PlacedObstacles[BestIndex];
+}
+
+// Metriche calcolate con una sola passata sulla griglia
+FGridMapScore FGridObstacleGenerator::ScoreMap(int32 Rows, int32 Columns, float ObstaclePercentage, const TArray<bool>& Obstacles)
+{
+    FGridMapScore Score;
+    const int32 TotalCells = Rows * Columns;
+    if (TotalCells <= 0)
+    {
+        return Score;
+    }
+
+    const int32 MaxObstacles = FMath::RoundToInt(TotalCells * (ObstaclePercentage / 100.0f));
+    int32 NumObstacles = 0;
+    int32 LargestSide = 0;
+
+    // Lato del pi grande quadrato libero che termina in ogni cella della riga precedente e di quella corrente
+    TArray<int32> PrevRow;
+    PrevRow.SetNumZeroed(Columns);
+    TArray<int32> CurrRow;
+    CurrRow.SetNumZeroed(Columns);
+
+    for (int32 Y = 0; Y < Rows; Y++)
+    {
+        for (int32 X = 0; X < Columns; X++)
+        {
+            const int32 Index = Y * Columns + X;
+            if (Obstacles[Index])
+            {
+                NumObstacles++;
+                CurrRow[X] = 0;
+                continue;
+            }
+
+            CurrRow[X] = (X > 0 && Y > 0) ? FMath::Min3(PrevRow[X], PrevRow[X - 1], CurrRow[X - 1]) + 1 : 1;
+            LargestSide = FMath::Max(LargestSide, CurrRow[X]);
+
+            const bool bFreeN = Y > 0 && !Obstacles[Index - Columns];
+            const bool bFreeS = Y < Rows - 1 && !Obstacles[Index + Columns];
+            const bool bFreeW = X > 0 && !Obstacles[Index - 1];
+            const bool bFreeE = X < Columns - 1 && !Obstacles[Index + 1];
+            if ((bFreeN && bFreeS && !bFreeW && !bFreeE) || (bFreeW && bFreeE && !bFreeN && !bFreeS))
+            {
+                Score.Chokepoints++;
+            }
+        }
+        Swap(PrevRow, CurrRow);
+    }
+
+    const int32 FreeCells = FMath::Max(TotalCells - NumObstacles, 1);
+    Score.ObstacleRatio = MaxObstacles > 0 ? FMath::Min(static_cast<float>(NumObstacles) / MaxObstacles, 1.f) : 1.f;
+    Score.LargestOpenArea = LargestSide * LargestSide;
+    Score.Total = ObstacleRatioWeight * Score.ObstacleRatio
+        - ChokepointWeight * static_cast<float>(Score.Chokepoints) / FreeCells
+        - OpenAreaWeight * static_cast<float>(Score.LargestOpenArea) / TotalCells;
+    return Score;
+}
+
+// Con una BFS controlla che non ci siano isole (celle libere non raggiungibili)
+bool FGridObstacleGenerator::IsGridFullyConnected(int32 Rows, int32 Columns, const TArray<bool>& Obstacles)
+{
+    const int32 TotalCells = Rows * Columns;
+
+    int32 Start = INDEX_NONE;
+    int32 TotalNonObstacleCells = 0;
+    for (int32 Index = 0; Index < TotalCells; Index++)
+    {
+        if (!Obstacles[Index])
+        {
+            if (Start == INDEX_NONE)
+            {
+                Start = Index;
+            }
+            TotalNonObstacleCells++;
+        }
+    }
+
+    // Se non viene trovata alcuna cella libera, la griglia non  valida
+    if (Start == INDEX_NONE)
+    {
+        return false;
+    }
+
+    TArray<bool> Visited;
+    Visited.Init(false, TotalCells);
+    TArray<int32> Queue;
+    Queue.Reserve(TotalNonObstacleCells);
+
+    Queue.Add(Start);
+    Visited[Start] = true;
+
+    for (int32 Head = 0; Head < Queue.Num(); Head++)
+    {
+        const int32 Current = Queue[Head];
+        const int32 CurrentX = Current % Columns;
+        const int32 CurrentY = Current / Columns;
+
+        for (int32 Dir = 0; Dir < 4; Dir++)
+        {
+            const int32 NewX = CurrentX + DirX[Dir];
+            const int32 NewY = CurrentY + DirY[Dir];
+            if (NewX >= 0 && NewX < Columns && NewY >= 0 && NewY < Rows)
+            {
+                const int32 Neighbor = NewY * Columns + NewX;
+                if (!Obstacles[Neighbor] && !Visited[Neighbor])
+                {
+                    Visited[Neighbor] = true;
+                    Queue.Add(Neighbor);
+                }
+            }
+        }
+    }
+
+    // La griglia  completamente connessa se tutte le celle non ostacolo sono raggiungibili
+    return Queue.Num() == TotalNonObstacleCells;
+}
+
+int32 FGridObstacleGenerator::GenerateObstaclesFullCheck(int32 Rows, int32 Columns, float ObstaclePercentage, FRandomStream& Stream, TArray<bool>& OutObstacles)
+{
+    const int32 TotalCells = Rows * Columns;
+    OutObstacles.Init(false, TotalCells);
+
+    const int32 MaxObstacles = FMath::RoundToInt(TotalCells * (ObstaclePercentage / 100.0f));
+    int32 PlacedObstacles = 0;
+
+    TArray<int32> AllPositions;
+    BuildShuffledPositions(TotalCells, Stream, AllPositions);
+
+    for (int32 Index : AllPositions)
+    {
+        if (PlacedObstacles >= MaxObstacles)
+        {
+            break;
+        }
+
+        OutObstacles[Index] = true;
+        if (IsGridFullyConnected(Rows, Columns, OutObstacles))
+        {
+            PlacedObstacles++;
+        }
+        else
+        {
+            OutObstacles[Index] = false;
+        }
+    }
+
+    return PlacedObstacles;
+}
+
+// Stampa nel log il tempo di generazione per ogni dimensione: la versione incrementale viene confrontata con
+// quella originale (BFS completa per ogni ostacolo) solo fino a 100x100, oltre diventa troppo lenta.
+// Tutte le mappe usano lo stesso seed, quindi le due versioni devono produrre esattamente la stessa disposizione
+void FGridObstacleGenerator::RunBenchmark(const TArray<int32>& GridSizes, float ObstaclePercentage, int32 Seed)
+{
+    UE_LOG(LogTemp, Warning, TEXT("Grid generation benchmark, %.1f%% obstacles, seed %d"), ObstaclePercentage, Seed);
+
+    for (int32 Size : GridSizes)
+    {
+        TArray<bool> Obstacles;
+        FRandomStream Stream(Seed);
+
+        double StartTime = FPlatformTime::Seconds();
+        int32 PlacedObstacles = GenerateObstacles(Size, Size, ObstaclePercentage, Stream, Obstacles);
+        double IncrementalMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+        bool bConnected = IsGridFullyConnected(Size, Size, Obstacles);
+
+        // Una seconda generazione con lo stesso seed deve dare una griglia identica
+        TArray<bool> RepeatedObstacles;
+        Stream.Initialize(Seed);
+        GenerateObstacles(Size, Size, ObstaclePercentage, Stream, RepeatedObstacles);
+        bool bReproducible = (RepeatedObstacles == Obstacles);
+
+        // Migliore tra pi candidate generate in parallelo: il tempo dovrebbe restare vicino a quello di una sola mappa
+        TArray<bool> BestObstacles;
+        FGridMapScore BestScore;
+        Stream.Initialize(Seed);
+        StartTime = FPlatformTime::Seconds();
+        GenerateBestObstacles(EGridGeneratorType::Incremental, Size, Size, ObstaclePercentage, BenchmarkCandidates, Stream, BestObstacles, BestScore);
+        double CandidatesMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+        // Generatore a campo di rumore con riparazione della connettivit
+        TArray<bool> NoiseObstacles;
+        Stream.Initialize(Seed);
+        StartTime = FPlatformTime::Seconds();
+        int32 NoisePlaced = GenerateNoiseObstacles(Size, Size, ObstaclePercentage, Stream, NoiseObstacles);
+        double NoiseMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+        bool bNoiseConnected = IsGridFullyConnected(Size, Size, NoiseObstacles);
+
+        FString FullCheckText = TEXT("skipped");
+        if (Size <= 100)
+        {
+            TArray<bool> FullCheckObstacles;
+            Stream.Initialize(Seed);
+            StartTime = FPlatformTime::Seconds();
+            GenerateObstaclesFullCheck(Size, Size, ObstaclePercentage, Stream, FullCheckObstacles);
+            FullCheckText = FString::Printf(TEXT("%.2f ms (%s)"), (FPlatformTime::Seconds() - StartTime) * 1000.0,
+                FullCheckObstacles == Obstacles ? TEXT("same layout") : TEXT("DIFFERENT layout"));
+        }
+
+        UE_LOG(LogTemp, Warning, TEXT("%dx%d (%d cells): %d obstacles, incremental %.2f ms, full BFS %s, connected: %s, reproducible: %s"),
+            Size, Size, Size * Size, PlacedObstacles, IncrementalMs, *FullCheckText, bConnected ? TEXT("yes") : TEXT("no"),
+            bReproducible ? TEXT("yes") : TEXT("no"));
+        UE_LOG(LogTemp, Warning, TEXT("    best of %d candidates: %.2f ms, score %.2f (ratio %.2f, largest open area %d, chokepoints %d)"),
+            BenchmarkCandidates, CandidatesMs, BestScore.Total, BestScore.ObstacleRatio, BestScore.LargestOpenArea, BestScore.Chokepoints);
+        UE_LOG(LogTemp, Warning, TEXT("    noise field: %d obstacles, %.2f ms, connected: %s"),
+            NoisePlaced, NoiseMs, bNoiseConnected ? TEXT("yes") : TEXT("no"));
+    }
+}
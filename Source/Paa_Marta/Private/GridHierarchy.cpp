@@ -0,0 +1,529 @@
+#include "GridHierarchy.h"
+#include "GridSearchContext.h"
+#include "GridPathfinder.h"
+#include "GridGenerator.h"
+#include "Algo/Reverse.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+
+namespace
+{
+    // Un tratto di bordo libero lungo almeno questo numero di celle ha due passaggi (alle estremit) invece di uno al centro
+    constexpr int32 MinRunForTwoEntrances = 6;
+
+    // Comando da console per lanciare il benchmark: Paa.BenchmarkHierarchicalPathfinding [Size1 Size2 ...]
+    FAutoConsoleCommand HierarchyBenchmarkCommand(
+        TEXT("Paa.BenchmarkHierarchicalPathfinding"),
+        TEXT("Compares hierarchical pathfinding with A* on large grids. Usage: Paa.BenchmarkHierarchicalPathfinding [Size1 Size2 ...]"),
+        FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+        {
+            TArray<int32> GridSizes;
+            for (const FString& Arg : Args)
+            {
+                int32 Size = FCString::Atoi(*Arg);
+                if (Size > 0)
+                {
+                    GridSizes.Add(Size);
+                }
+            }
+            if (GridSizes.Num() == 0)
+            {
+                GridSizes = { 128, 256, 512 };
+            }
+            FGridHierarchy::RunBenchmark(GridSizes, 16, 50, 12345);
+        }));
+}
+
+void FGridHierarchy::Build(int32 InRows, int32 InColumns, int32 InClusterSize, const TArray<bool>& Obstacles, const TArray<bool>& Occupied)
+{
+    Rows = InRows;
+    Columns = InColumns;
+    ClusterSize = FMath::Max(InClusterSize, 2);
+    ClusterCountX = FMath::DivideAndRoundUp(Columns, ClusterSize);
+    ClusterCountY = FMath::DivideAndRoundUp(Rows, ClusterSize);
+
+    Clusters.Reset();
+    Clusters.SetNum(ClusterCountX * ClusterCountY);
+    DirtyClusters.Reset();
+    CellNodeIndex.Init(INDEX_NONE, Rows * Columns);
+    LocalDistance.SetNumUninitialized(ClusterSize * ClusterSize);
+    LocalParent.SetNumUninitialized(ClusterSize * ClusterSize);
+    LocalFrontier.Reserve(ClusterSize * ClusterSize);
+
+    for (int32 ClusterY = 0; ClusterY < ClusterCountY; ClusterY++)
+    {
+        for (int32 ClusterX = 0; ClusterX < ClusterCountX; ClusterX++)
+        {
+            FCluster& Cluster = Clusters[ClusterY * ClusterCountX + ClusterX];
+            Cluster.MinX = ClusterX * ClusterSize;
+            Cluster.MinY = ClusterY * ClusterSize;
+            Cluster.MaxX = FMath::Min(Cluster.MinX + ClusterSize, Columns);
+            Cluster.MaxY = FMath::Min(Cluster.MinY + ClusterSize, Rows);
+        }
+    }
+
+    for (int32 ClusterIndex = 0; ClusterIndex < Clusters.Num(); ClusterIndex++)
+    {
+        RebuildCluster(ClusterIndex, Obstacles, Occupied);
+    }
+}
+
+void FGridHierarchy::MarkCellChanged(int32 Cell)
+{
+    if (!IsBuilt())
+    {
+        return;
+    }
+
+    const int32 X = Cell % Columns;
+    const int32 Y = Cell / Columns;
+    const int32 ClusterX = X / ClusterSize;
+    const int32 ClusterY = Y / ClusterSize;
+
+    auto MarkDirty = [this](int32 MarkX, int32 MarkY)
+    {
+        FCluster& Cluster = Clusters[MarkY * ClusterCountX + MarkX];
+        if (!Cluster.bDirty)
+        {
+            Cluster.bDirty = true;
+            DirtyClusters.Add(MarkY * ClusterCountX + MarkX);
+        }
+    };
+
+    // Una cella di bordo decide anche i passaggi del cluster confinante
+    MarkDirty(ClusterX, ClusterY);
+    if (X % ClusterSize == 0 && ClusterX > 0)
+    {
+        MarkDirty(ClusterX - 1, ClusterY);
+    }
+    if (X % ClusterSize == ClusterSize - 1 && ClusterX + 1 < ClusterCountX)
+    {
+        MarkDirty(ClusterX + 1, ClusterY);
+    }
+    if (Y % ClusterSize == 0 && ClusterY > 0)
+    {
+        MarkDirty(ClusterX, ClusterY - 1);
+    }
+    if (Y % ClusterSize == ClusterSize - 1 && ClusterY + 1 < ClusterCountY)
+    {
+        MarkDirty(ClusterX, ClusterY + 1);
+    }
+}
+
+int32 FGridHierarchy::UpdateDirtyClusters(const TArray<bool>& Obstacles, const TArray<bool>& Occupied)
+{
+    const int32 NumRebuilt = DirtyClusters.Num();
+    for (int32 ClusterIndex : DirtyClusters)
+    {
+        RebuildCluster(ClusterIndex, Obstacles, Occupied);
+    }
+    DirtyClusters.Reset();
+    return NumRebuilt;
+}
+
+void FGridHierarchy::RebuildCluster(int32 ClusterIndex, const TArray<bool>& Obstacles, const TArray<bool>& Occupied)
+{
+    FCluster& Cluster = Clusters[ClusterIndex];
+
+    for (const FNode& Node : Cluster.Nodes)
+    {
+        CellNodeIndex[Node.Cell] = INDEX_NONE;
+    }
+    Cluster.Nodes.Reset();
+
+    for (int32 Direction = 0; Direction < 4; Direction++)
+    {
+        AddBorderNodes(Cluster, Direction, Obstacles, Occupied);
+    }
+
+    const int32 NumNodes = Cluster.Nodes.Num();
+    for (int32 NodeIndex = 0; NodeIndex < NumNodes; NodeIndex++)
+    {
+        CellNodeIndex[Cluster.Nodes[NodeIndex].Cell] = NodeIndex;
+    }
+
+    // Una BFS dentro al cluster per ogni nodo d le distanze verso tutti gli altri nodi
+    Cluster.NodeDistances.SetNumUninitialized(NumNodes * NumNodes);
+    for (int32 From = 0; From < NumNodes; From++)
+    {
+        SearchCluster(Cluster, Cluster.Nodes[From].Cell, INDEX_NONE, Obstacles, Occupied);
+        for (int32 To = 0; To < NumNodes; To++)
+        {
+            Cluster.NodeDistances[From * NumNodes + To] = LocalDistance[ToLocal(Cluster, Cluster.Nodes[To].Cell)];
+        }
+    }
+
+    Cluster.bDirty = false;
+}
+
+void FGridHierarchy::AddBorderNodes(FCluster& Cluster, int32 Direction, const TArray<bool>& Obstacles, const TArray<bool>& Occupied)
+{
+    // Bordo del cluster (Inside) e celle confinanti nel cluster vicino (Outside), percorsi lungo il bordo
+    const bool bHorizontalBorder = (Direction == 0 || Direction == 2);
+    int32 InsideLine = 0;
+    int32 OutsideLine = 0;
+    switch (Direction)
+    {
+    case 0:
+        if (Cluster.MinY == 0) return;
+        InsideLine = Cluster.MinY;
+        OutsideLine = Cluster.MinY - 1;
+        break;
+    case 1:
+        if (Cluster.MaxX == Columns) return;
+        InsideLine = Cluster.MaxX - 1;
+        OutsideLine = Cluster.MaxX;
+        break;
+    case 2:
+        if (Cluster.MaxY == Rows) return;
+        InsideLine = Cluster.MaxY - 1;
+        OutsideLine = Cluster.MaxY;
+        break;
+    default:
+        if (Cluster.MinX == 0) return;
+        InsideLine = Cluster.MinX;
+        OutsideLine = Cluster.MinX - 1;
+        break;
+    }
+
+    const int32 First = bHorizontalBorder ? Cluster.MinX : Cluster.MinY;
+    const int32 Last = bHorizontalBorder ? Cluster.MaxX : Cluster.MaxY;
+
+    auto CellAt = [this, bHorizontalBorder](int32 Line, int32 Along)
+    {
+        return bHorizontalBorder ? Line * Columns + Along : Along * Columns + Line;
+    };
+
+    auto AddTransition = [&](int32 Along)
+    {
+        const int32 Inside = CellAt(InsideLine, Along);
+        const int32 Outside = CellAt(OutsideLine, Along);
+
+        // Negli angoli la stessa cella pu essere un passaggio verso due cluster
+        FNode* Node = Cluster.Nodes.FindByPredicate([Inside](const FNode& Existing) { return Existing.Cell == Inside; });
+        if (!Node)
+        {
+            Node = &Cluster.Nodes.AddDefaulted_GetRef();
+            Node->Cell = Inside;
+        }
+        Node->Partners.Add(Outside);
+    };
+
+    // Divide il bordo in tratti liberi da entrambe le parti
+    int32 RunStart = INDEX_NONE;
+    for (int32 Along = First; Along <= Last; Along++)
+    {
+        bool bOpen = false;
+        if (Along < Last)
+        {
+            const int32 Inside = CellAt(InsideLine, Along);
+            const int32 Outside = CellAt(OutsideLine, Along);
+            bOpen = !Obstacles[Inside] && !Occupied[Inside] && !Obstacles[Outside] && !Occupied[Outside];
+        }
+
+        if (bOpen && RunStart == INDEX_NONE)
+        {
+            RunStart = Along;
+        }
+        else if (!bOpen && RunStart != INDEX_NONE)
+        {
+            const int32 RunEnd = Along - 1;
+            if (RunEnd - RunStart + 1 >= MinRunForTwoEntrances)
+            {
+                AddTransition(RunStart);
+                AddTransition(RunEnd);
+            }
+            else
+            {
+                AddTransition((RunStart + RunEnd) / 2);
+            }
+            RunStart = INDEX_NONE;
+        }
+    }
+}
+
+void FGridHierarchy::SearchCluster(const FCluster& Cluster, int32 Source, int32 ExtraPassable, const TArray<bool>& Obstacles, const TArray<bool>& Occupied)
+{
+    for (int32 Y = Cluster.MinY; Y < Cluster.MaxY; Y++)
+    {
+        const int32 RowStart = (Y - Cluster.MinY) * ClusterSize;
+        for (int32 Local = RowStart; Local < RowStart + Cluster.MaxX - Cluster.MinX; Local++)
+        {
+            LocalDistance[Local] = INDEX_NONE;
+        }
+    }
+
+    LocalFrontier.Reset();
+    LocalFrontier.Add(Source);
+    LocalDistance[ToLocal(Cluster, Source)] = 0;
+    LocalParent[ToLocal(Cluster, Source)] = INDEX_NONE;
+
+    for (int32 Head = 0; Head < LocalFrontier.Num(); Head++)
+    {
+        const int32 Current = LocalFrontier[Head];
+        const int32 CurrentX = Current % Columns;
+        const int32 CurrentY = Current / Columns;
+        const int32 NextDistance = LocalDistance[ToLocal(Cluster, Current)] + 1;
+
+        const int32 Neighbors[4] = {
+            CurrentY > Cluster.MinY ? Current - Columns : INDEX_NONE,
+            CurrentX < Cluster.MaxX - 1 ? Current + 1 : INDEX_NONE,
+            CurrentY < Cluster.MaxY - 1 ? Current + Columns : INDEX_NONE,
+            CurrentX > Cluster.MinX ? Current - 1 : INDEX_NONE
+        };
+
+        for (int32 Neighbor : Neighbors)
+        {
+            if (Neighbor == INDEX_NONE || Obstacles[Neighbor] || (Occupied[Neighbor] && Neighbor != ExtraPassable))
+            {
+                continue;
+            }
+            const int32 Local = ToLocal(Cluster, Neighbor);
+            if (LocalDistance[Local] == INDEX_NONE)
+            {
+                LocalDistance[Local] = NextDistance;
+                LocalParent[Local] = Current;
+                LocalFrontier.Add(Neighbor);
+            }
+        }
+    }
+}
+
+bool FGridHierarchy::FindPath(const TArray<bool>& Obstacles, const TArray<bool>& Occupied, int32 Start, int32 Goal,
+    FGridSearchContext& Context, TArray<int32>& OutPath)
+{
+    OutPath.Reset();
+
+    const int32 TotalCells = Rows * Columns;
+    if (!IsBuilt() || Start < 0 || Start >= TotalCells || Goal < 0 || Goal >= TotalCells)
+    {
+        return false;
+    }
+
+    UpdateDirtyClusters(Obstacles, Occupied);
+
+    const int32 GoalX = Goal % Columns;
+    const int32 GoalY = Goal / Columns;
+    auto Heuristic = [this, GoalX, GoalY](int32 Cell)
+    {
+        return FMath::Abs(Cell % Columns - GoalX) + FMath::Abs(Cell / Columns - GoalY);
+    };
+
+    // Tra celle vicine o nello stesso cluster il grafo astratto non serve
+    const int32 StartClusterIndex = GetClusterIndex(Start);
+    const int32 GoalClusterIndex = GetClusterIndex(Goal);
+    if (StartClusterIndex == GoalClusterIndex || Heuristic(Start) <= ClusterSize)
+    {
+        return FGridPathfinder::FindPath(Rows, Columns, Obstacles, Occupied, Start, Goal, Context, OutPath);
+    }
+
+    // Collega temporaneamente partenza e obiettivo ai nodi dei loro cluster
+    const FCluster& StartCluster = Clusters[StartClusterIndex];
+    const FCluster& GoalCluster = Clusters[GoalClusterIndex];
+
+    SearchCluster(StartCluster, Start, INDEX_NONE, Obstacles, Occupied);
+    StartLinks.Reset();
+    for (const FNode& Node : StartCluster.Nodes)
+    {
+        StartLinks.Add(LocalDistance[ToLocal(StartCluster, Node.Cell)]);
+    }
+
+    SearchCluster(GoalCluster, Goal, INDEX_NONE, Obstacles, Occupied);
+    GoalLinks.Reset();
+    for (const FNode& Node : GoalCluster.Nodes)
+    {
+        GoalLinks.Add(LocalDistance[ToLocal(GoalCluster, Node.Cell)]);
+    }
+
+    // A* sul grafo astratto: i nodi sono celle, quindi si usano i buffer per cella del contesto
+    Context.BeginSearch(TotalCells);
+    FGridOpenList Open(Context);
+
+    auto Relax = [&](int32 From, int32 Cell, int32 EdgeCost)
+    {
+        const int32 NewCost = Context.GetCost(From) + EdgeCost;
+        if (!Context.IsVisited(Cell))
+        {
+            Context.Visit(Cell, From, NewCost);
+            Context.HeapSlot[Cell] = INDEX_NONE;
+        }
+        else if (Context.HeapSlot[Cell] == FGridSearchContext::ClosedSlot || NewCost >= Context.GetCost(Cell))
+        {
+            return;
+        }
+        else
+        {
+            Context.SetParentAndCost(Cell, From, NewCost);
+        }
+        Context.Score[Cell] = NewCost + Heuristic(Cell);
+        Open.PushOrUpdate(Cell);
+    };
+
+    Context.Visit(Start, INDEX_NONE, 0);
+    Context.HeapSlot[Start] = INDEX_NONE;
+    Context.Score[Start] = Heuristic(Start);
+    Open.PushOrUpdate(Start);
+
+    bool bFound = false;
+    while (!Open.IsEmpty())
+    {
+        const int32 Current = Open.Pop();
+        if (Current == Goal)
+        {
+            bFound = true;
+            break;
+        }
+
+        if (Current == Start)
+        {
+            for (int32 NodeIndex = 0; NodeIndex < StartLinks.Num(); NodeIndex++)
+            {
+                if (StartLinks[NodeIndex] != INDEX_NONE)
+                {
+                    Relax(Current, StartCluster.Nodes[NodeIndex].Cell, StartLinks[NodeIndex]);
+                }
+            }
+        }
+
+        const int32 NodeIndex = CellNodeIndex[Current];
+        if (NodeIndex == INDEX_NONE)
+        {
+            continue;
+        }
+
+        const int32 ClusterIndex = GetClusterIndex(Current);
+        const FCluster& Cluster = Clusters[ClusterIndex];
+        const int32 NumNodes = Cluster.Nodes.Num();
+        for (int32 Other = 0; Other < NumNodes; Other++)
+        {
+            const int32 Distance = Cluster.NodeDistances[NodeIndex * NumNodes + Other];
+            if (Other != NodeIndex && Distance != INDEX_NONE)
+            {
+                Relax(Current, Cluster.Nodes[Other].Cell, Distance);
+            }
+        }
+        for (int32 Partner : Cluster.Nodes[NodeIndex].Partners)
+        {
+            Relax(Current, Partner, 1);
+        }
+        if (ClusterIndex == GoalClusterIndex && GoalLinks[NodeIndex] != INDEX_NONE)
+        {
+            Relax(Current, Goal, GoalLinks[NodeIndex]);
+        }
+    }
+
+    // Partenza o obiettivo occupati sul bordo possono avere come unica uscita il cluster vicino,
+    // che il grafo non collega: in quel caso decide la ricerca sulla griglia
+    if (!bFound)
+    {
+        return FGridPathfinder::FindPath(Rows, Columns, Obstacles, Occupied, Start, Goal, Context, OutPath);
+    }
+
+    AbstractPath.Reset();
+    for (int32 Cell = Goal; Cell != INDEX_NONE; Cell = Context.GetParent(Cell))
+    {
+        AbstractPath.Add(Cell);
+    }
+    Algo::Reverse(AbstractPath);
+
+    // Ricostruisce ogni tratto astratto cella per cella con una BFS limitata al suo cluster
+    OutPath.Add(Start);
+    for (int32 Step = 1; Step < AbstractPath.Num(); Step++)
+    {
+        const int32 From = AbstractPath[Step - 1];
+        const int32 To = AbstractPath[Step];
+        if (FMath::Abs(From % Columns - To % Columns) + FMath::Abs(From / Columns - To / Columns) == 1)
+        {
+            OutPath.Add(To);
+            continue;
+        }
+
+        const FCluster& Cluster = Clusters[GetClusterIndex(To)];
+        check(GetClusterIndex(From) == GetClusterIndex(To));
+        SearchCluster(Cluster, From, To, Obstacles, Occupied);
+
+        const int32 SegmentStart = OutPath.Num();
+        for (int32 Cell = To; Cell != From; Cell = LocalParent[ToLocal(Cluster, Cell)])
+        {
+            OutPath.Add(Cell);
+        }
+        for (int32 Left = SegmentStart, Right = OutPath.Num() - 1; Left < Right; Left++, Right--)
+        {
+            OutPath.Swap(Left, Right);
+        }
+    }
+    return true;
+}
+
+int32 FGridHierarchy::GetNumNodes() const
+{
+    int32 NumNodes = 0;
+    for (const FCluster& Cluster : Clusters)
+    {
+        NumNodes += Cluster.Nodes.Num();
+    }
+    return NumNodes;
+}
+
+// Stampa nel log tempo di costruzione, numero di nodi e, sulle stesse coppie di celle, tempo per ricerca
+// e lunghezza media dei percorsi rispetto all'A* sulla griglia
+void FGridHierarchy::RunBenchmark(const TArray<int32>& GridSizes, int32 ClusterSize, int32 QueriesPerSize, int32 Seed)
+{
+    UE_LOG(LogTemp, Warning, TEXT("Hierarchical pathfinding benchmark, clusters of %d cells per side, %d queries per size, seed %d"),
+        ClusterSize, QueriesPerSize, Seed);
+
+    for (int32 Size : GridSizes)
+    {
+        FRandomStream Stream(Seed);
+        TArray<bool> Obstacles;
+        FGridObstacleGenerator::Generate(EGridGeneratorType::NoiseField, Size, Size, 20.0f, Stream, Obstacles);
+
+        TArray<bool> Occupied;
+        Occupied.Init(false, Size * Size);
+
+        TArray<int32> FreeCells;
+        for (int32 Index = 0; Index < Obstacles.Num(); Index++)
+        {
+            if (!Obstacles[Index])
+            {
+                FreeCells.Add(Index);
+            }
+        }
+
+        FGridHierarchy Hierarchy;
+        double StartTime = FPlatformTime::Seconds();
+        Hierarchy.Build(Size, Size, ClusterSize, Obstacles, Occupied);
+        const double BuildMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+        TArray<TPair<int32, int32>> Queries;
+        for (int32 i = 0; i < QueriesPerSize; i++)
+        {
+            Queries.Add(TPair<int32, int32>(FreeCells[Stream.RandRange(0, FreeCells.Num() - 1)], FreeCells[Stream.RandRange(0, FreeCells.Num() - 1)]));
+        }
+
+        FGridSearchContext Context;
+        TArray<int32> Path;
+        int64 HierarchyLength = 0;
+        StartTime = FPlatformTime::Seconds();
+        for (const TPair<int32, int32>& Query : Queries)
+        {
+            Hierarchy.FindPath(Obstacles, Occupied, Query.Key, Query.Value, Context, Path);
+            HierarchyLength += Path.Num();
+        }
+        const double HierarchyUs = (FPlatformTime::Seconds() - StartTime) * 1000000.0 / Queries.Num();
+
+        int64 AStarLength = 0;
+        StartTime = FPlatformTime::Seconds();
+        for (const TPair<int32, int32>& Query : Queries)
+        {
+            FGridPathfinder::FindPath(Size, Size, Obstacles, Occupied, Query.Key, Query.Value, Context, Path);
+            AStarLength += Path.Num();
+        }
+        const double AStarUs = (FPlatformTime::Seconds() - StartTime) * 1000000.0 / Queries.Num();
+
+        UE_LOG(LogTemp, Warning, TEXT("%dx%d: built in %.2f ms (%d nodes), hierarchical %.1f us/query, A* %.1f us/query, path length +%.1f%%"),
+            Size, Size, BuildMs, Hierarchy.GetNumNodes(), HierarchyUs, AStarUs,
+            AStarLength > 0 ? (HierarchyLength - AStarLength) * 100.0 / AStarLength : 0.0);
+    }
+}
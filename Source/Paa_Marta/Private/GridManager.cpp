@@ -1,15 +1,86 @@
 #include "GridManager.h"
 #include "GridCell.h"
+#include "GridGenerator.h"
 #include "Engine/World.h"
 #include "Math/UnrealMathUtility.h"
 #include "EngineUtils.h" 
+#include "Components/InstancedStaticMeshComponent.h"
+#include "UObject/ConstructorHelpers.h"
+#include "GameFramework/PlayerController.h"
+#include "Camera/PlayerCameraManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+#include "Tasks/Task.h"
+#include "Engine/Texture2D.h"
+#include "Materials/MaterialInstanceDynamic.h"
+#include "Algo/Reverse.h"
 
 AGridManager* AGridManager::Instance = nullptr;
 
+namespace
+{
+    // Celle aggiunte alle componenti instanziate per ogni chiamata durante la creazione a tempo
+    const int32 InstanceBatchSize = 1024;
+
+    // Comando da console per stampare il seed della griglia corrente
+    FAutoConsoleCommandWithWorld PrintGridSeedCommand(
+        TEXT("Paa.PrintGridSeed"),
+        TEXT("Logs the seed used to generate the current grid (reuse it with -GridSeed=N)."),
+        FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+        {
+            for (TActorIterator<AGridManager> It(World); It; ++It)
+            {
+                UE_LOG(LogTemp, Warning, TEXT("Grid seed: %d"), It->GetActiveGridSeed());
+                return;
+            }
+            UE_LOG(LogTemp, Warning, TEXT("No GridManager in the current world"));
+        }));
+}
+
 // Costruttore della classe AGridManager
 AGridManager::AGridManager()
 {
-    PrimaryActorTick.bCanEverTick = false;
+    // Il tick serve solo per lo streaming dei chunk e viene attivato da InitializeGrid
+    PrimaryActorTick.bCanEverTick = true;
+    PrimaryActorTick.bStartWithTickEnabled = false;
+
+    RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+
+    static ConstructorHelpers::FObjectFinder<UStaticMesh> CubeMesh(TEXT("/Engine/BasicShapes/Cube.Cube"));
+
+    // Componenti instanziate per la modalit Instanced: restano vuote se le celle sono attori.
+    // La collisione  disattivata, il click viene calcolato sul piano della griglia (GetCellIndexFromRay)
+    UInstancedStaticMeshComponent** CellComponents[] = { &NormalCellsISM, &TreeCellsISM, &MountainCellsISM };
+    const TCHAR* CellComponentNames[] = { TEXT("NormalCells"), TEXT("TreeCells"), TEXT("MountainCells") };
+
+    for (int32 i = 0; i < UE_ARRAY_COUNT(CellComponents); i++)
+    {
+        UInstancedStaticMeshComponent* Component = CreateDefaultSubobject<UInstancedStaticMeshComponent>(CellComponentNames[i]);
+        Component->SetupAttachment(RootComponent);
+        Component->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+        Component->SetMobility(EComponentMobility::Static);
+        if (CubeMesh.Succeeded())
+        {
+            Component->SetStaticMesh(CubeMesh.Object);
+        }
+        *CellComponents[i] = Component;
+    }
+
+    HoverInfoBox = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("HoverInfoBox"));
+    HoverInfoBox->SetupAttachment(RootComponent);
+    HoverInfoBox->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+    if (CubeMesh.Succeeded())
+    {
+        HoverInfoBox->SetStaticMesh(CubeMesh.Object);
+    }
+
+    static ConstructorHelpers::FObjectFinder<UMaterialInterface> BoxMaterialAsset(TEXT("/Engine/BasicShapes/BasicShapeMaterial.BasicShapeMaterial"));
+    if (BoxMaterialAsset.Succeeded())
+    {
+        HoverInfoBox->SetMaterial(0, BoxMaterialAsset.Object);
+    }
+    HoverInfoBox->SetVisibility(false);
 }
 
 // Funzione chiamata all'avvio del gioco: inizializza la griglia (inclusa la generazione degli ostacoli e lo spawn delle celle)
@@ -31,236 +102,979 @@ void AGridManager::BeginPlay()
     InitializeGrid();
 }
 
-// Funzione per generare gli ostacoli sulla griglia e controlla che la griglia rimanga completamente connessa
-void AGridManager::GenerateObstacles()
+// Genera i dati della griglia: ostacoli (entrambi i generatori garantiscono che la griglia rimanga
+// completamente connessa) e aspetto delle celle. Tutta la casualit viene da uno stream inizializzato con il seed
+void AGridManager::BuildLayout(FGridLayout& Layout)
 {
-    GridObstacles.SetNum(GridRows);
-    for (int32 Row = 0; Row < GridRows; Row++)
+    FRandomStream Stream(Layout.Seed);
+
+    if (Layout.MapCandidates > 1)
     {
-        GridObstacles[Row].Init(false, GridColumns);
+        Layout.PlacedObstacles = FGridObstacleGenerator::GenerateBestObstacles(Layout.GeneratorType, Layout.Rows, Layout.Columns,
+            Layout.ObstaclePercentage, Layout.MapCandidates, Stream, Layout.Obstacles, Layout.Score);
+    }
+    else
+    {
+        Layout.PlacedObstacles = FGridObstacleGenerator::Generate(Layout.GeneratorType, Layout.Rows, Layout.Columns,
+            Layout.ObstaclePercentage, Stream, Layout.Obstacles);
     }
 
-    int32 TotalCells = GridRows * GridColumns;
-    int32 MaxObstacles = FMath::RoundToInt(TotalCells * (ObstaclePercentage / 100.0f));
-    int32 PlacedObstacles = 0;
+    // I dati visivi sono ordinati per chunk: l'ultimo chunk di ogni riga/colonna pu essere incompleto
+    const int32 NumChunkCountX = FMath::DivideAndRoundUp(Layout.Columns, Layout.ChunkSize);
+    const int32 NumChunkCountY = FMath::DivideAndRoundUp(Layout.Rows, Layout.ChunkSize);
+    Layout.Visuals.Init(EGridCellVisual::Normal, NumChunkCountX * NumChunkCountY * Layout.ChunkSize * Layout.ChunkSize);
 
-    // Crea una lista di tutte le posizioni possibili nella griglia
-    TArray<FGridPosition> AllPositions;
-    for (int32 Row = 0; Row < GridRows; Row++)
+    // Ci sono due tipi di ostacolo e materiale: alberi e montagne (distribuite in modo casuale).
+    // Lo stream viene usato anche senza MountainMaterial, cos la sequenza dipende solo dal seed
+    for (int32 Index = 0; Index < Layout.Obstacles.Num(); Index++)
     {
-        for (int32 Col = 0; Col < GridColumns; Col++)
+        if (Layout.Obstacles[Index])
         {
-            AllPositions.Add(FGridPosition(Col, Row));
+            const bool bMountain = Stream.RandRange(0, 1) == 1;
+            const int32 Tile = ComputeTileIndex(Index % Layout.Columns, Index / Layout.Columns, Layout.ChunkSize, NumChunkCountX);
+            Layout.Visuals[Tile] = (Layout.bUseMountains && bMountain) ? EGridCellVisual::Mountain : EGridCellVisual::Tree;
         }
     }
 
-    for (int32 i = 0; i < AllPositions.Num(); i++)
+    // Gli ostacoli da qui in poi non cambiano pi: la tabella delle distanze resta valida per tutta la partita
+    if (Layout.bBuildDistanceTable)
+    {
+        const double StartTime = FPlatformTime::Seconds();
+        Layout.DistanceTable.Build(Layout.Rows, Layout.Columns, Layout.Obstacles);
+        Layout.DistanceTableBuildMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+    }
+
+    // Il grafo gerarchico parte dalla griglia vuota, poi segue l'occupazione ricostruendo solo i cluster toccati
+    if (Layout.HierarchyClusterSize > 0)
+    {
+        TArray<bool> Occupied;
+        Occupied.Init(false, Layout.Rows * Layout.Columns);
+        const double StartTime = FPlatformTime::Seconds();
+        Layout.Hierarchy.Build(Layout.Rows, Layout.Columns, Layout.HierarchyClusterSize, Layout.Obstacles, Occupied);
+        Layout.HierarchyBuildMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+    }
+}
+
+void AGridManager::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    if (!bGridReady)
+    {
+        UpdateInitialization();
+        return;
+    }
+
+    if (bHighlightDirty)
+    {
+        FlushHighlights();
+    }
+
+    if (PathService.HasPendingRequests())
+    {
+        PathService.Update();
+    }
+
+    // Il tick resta attivo solo per lo streaming, evidenziazioni e richieste di percorso lo riattivano quando serve.
+    // Le callback dei percorsi possono aver appena cambiato delle evidenziazioni: vengono inviate al prossimo tick
+    if (IsStreamed())
+    {
+        UpdateStreaming();
+    }
+    else if (!PathService.HasPendingRequests() && !bHighlightDirty)
+    {
+        SetActorTickEnabled(false);
+    }
+}
+
+AGridManager* AGridManager::GetInstance(UWorld* World)
+{
+    if (!Instance)
     {
-        int32 SwapIndex = FMath::RandRange(i, AllPositions.Num() - 1);
-        if (i != SwapIndex)
+        // Cerca un'istanza gi esistente nel mondo
+        for (TActorIterator<AGridManager> It(World); It; ++It)
         {
-            AllPositions.Swap(i, SwapIndex);
+            Instance = *It;
+            break;
+        }
+        // Se non viene trovata, crea una nuova istanza
+        if (!Instance)
+        {
+            Instance = World->SpawnActor<AGridManager>(AGridManager::StaticClass(), FTransform::Identity);
         }
     }
+    return Instance;
+}
+
+// Funzione per inizializzare la griglia. I dati (ostacoli e aspetto delle celle) vengono generati in background,
+// poi le celle vengono create nel tick un po' per frame, come attori oppure come istanze a seconda di RenderMode.
+// Al termine viene lanciato OnGridReady
+void AGridManager::InitializeGrid()
+{
+    UE_LOG(LogTemp, Warning, TEXT("InitializeGrid() called manually."));
+
+    // Verifica che la classe delle celle sia assegnata (serve solo se le celle sono attori)
+    if (!IsInstanced() && !GridCellClass)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("GridCellClass has not been assigned in GridManager"));
+        return;
+    }
+
+    // Verifica che i materiali siano stati assegnati
+    if (!NormalMaterial || !ObstacleMaterial)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Materials not assigned in GridManager"));
+    }
 
-    // Prova ad aggiungere ostacoli, controllando che la griglia rimanga connessa
-    for (const FGridPosition& Pos : AllPositions)
+    // Rilascia i chunk di un'eventuale griglia precedente
+    for (int32 ChunkIndex : TArray<int32>(LoadedChunks))
     {
-        // Imposta temporaneamente la posizione come ostacolo
-        GridObstacles[Pos.Y][Pos.X] = true;
+        UnloadChunk(ChunkIndex);
+    }
 
-        // Verifica se la griglia  ancora completamente connessa
-        if (IsGridFullyConnected())
+    // Resetta gli array delle celle e degli ostacoli: finch il layout non  pronto la griglia  vuota
+    GridCells.Empty();
+    CellObstacles.Empty();
+    CellOccupied.Empty();
+    CellUnits.Empty();
+    bGridReady = false;
+    SpawnCursor = 0;
+
+    // Sceglie il seed: riga di comando (-GridSeed=N), poi la propriet, altrimenti un seed casuale
+    ActiveGridSeed = GridSeed;
+    FParse::Value(FCommandLine::Get(), TEXT("GridSeed="), ActiveGridSeed);
+    if (ActiveGridSeed == 0)
+    {
+        ActiveGridSeed = FMath::RandRange(1, MAX_int32);
+    }
+    UE_LOG(LogTemp, Warning, TEXT("Generating grid with seed %d"), ActiveGridSeed);
+
+    TSharedPtr<FGridLayout> Layout = MakeShared<FGridLayout>();
+    Layout->Rows = GridRows;
+    Layout->Columns = GridColumns;
+    Layout->ObstaclePercentage = ObstaclePercentage;
+    Layout->GeneratorType = GeneratorType;
+    Layout->MapCandidates = MapCandidates;
+    Layout->Seed = ActiveGridSeed;
+    Layout->ChunkSize = ChunkSize;
+    Layout->bUseMountains = (MountainMaterial != nullptr);
+    Layout->bBuildDistanceTable = bBuildDistanceTable && GridRows * GridColumns <= DistanceTableMaxCells;
+    Layout->HierarchyClusterSize = (!Layout->bBuildDistanceTable && GridRows * GridColumns >= HierarchyMinCells) ? HierarchyClusterSize : 0;
+
+    // Il task lavora solo sulla propria copia del layout, quindi non serve sincronizzazione
+    PendingLayout = Layout;
+    InitializationStartTime = FPlatformTime::Seconds();
+    LayoutTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, [Layout]()
+    {
+        BuildLayout(*Layout);
+    });
+
+    SetActorTickEnabled(true);
+}
+
+void AGridManager::UpdateInitialization()
+{
+    // Aspetta che il layout sia stato generato
+    if (PendingLayout.IsValid())
+    {
+        if (!LayoutTask.IsCompleted())
         {
-            // Ostacolo accettato
-            PlacedObstacles++;
-            if (PlacedObstacles >= MaxObstacles)
-            {
-                break;
-            }
+            return;
+        }
+        ApplyLayout(*PendingLayout);
+        PendingLayout.Reset();
+    }
+
+    // In modalit Streamed le celle vengono create dallo streaming dei chunk
+    if (IsStreamed())
+    {
+        FinishInitialization();
+        return;
+    }
+
+    const double Deadline = FPlatformTime::Seconds() + SpawnBudgetMs / 1000.0;
+    const int32 NumCells = GetNumCells();
+
+    while (SpawnCursor < NumCells && FPlatformTime::Seconds() < Deadline)
+    {
+        if (IsInstanced())
+        {
+            const int32 BatchEnd = FMath::Min(SpawnCursor + InstanceBatchSize, NumCells);
+            AddCellInstances(SpawnCursor, BatchEnd);
+            SpawnCursor = BatchEnd;
         }
         else
         {
-            // Ostacolo rifiutato, lo rimuove
-            GridObstacles[Pos.Y][Pos.X] = false;
+            SpawnCellActor(SpawnCursor);
+            SpawnCursor++;
         }
     }
 
-    UE_LOG(LogTemp, Warning, TEXT("Generated %d obstacles out of a maximum of %d requested."), PlacedObstacles, MaxObstacles);
+    if (SpawnCursor >= NumCells)
+    {
+        FinishInitialization();
+    }
 }
 
-// Con una BFS gestisco la griglia e gli ostacoli in modo da non creare isole (celle in cui non posso arrivare), funzione che chiama a sua volta la funzione FindConnectedCells() per controllare la connettivit
-bool AGridManager::IsGridFullyConnected()
+void AGridManager::ApplyLayout(FGridLayout& Layout)
 {
-    FGridPosition Start(-1, -1);
-    for (int32 Row = 0; Row < GridRows; Row++)
+    CellObstacles = MoveTemp(Layout.Obstacles);
+    CellVisuals = MoveTemp(Layout.Visuals);
+    DistanceTable = MoveTemp(Layout.DistanceTable);
+    Hierarchy = MoveTemp(Layout.Hierarchy);
+
+    if (DistanceTable.IsBuilt())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("All-pairs distance table: %d free cells, built in %.2f ms, %.2f MB"),
+            DistanceTable.GetNumFreeCells(), Layout.DistanceTableBuildMs, DistanceTable.GetAllocatedSize() / (1024.0 * 1024.0));
+    }
+    if (Hierarchy.IsBuilt())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Hierarchical pathfinding graph: %d nodes, built in %.2f ms"), Hierarchy.GetNumNodes(), Layout.HierarchyBuildMs);
+    }
+
+    if (MapCandidates > 1)
     {
-        for (int32 Col = 0; Col < GridColumns; Col++)
+        UE_LOG(LogTemp, Warning, TEXT("Best of %d candidate maps: score %.2f (largest open area %d, chokepoints %d)"),
+            MapCandidates, Layout.Score.Total, Layout.Score.LargestOpenArea, Layout.Score.Chokepoints);
+    }
+
+    int32 MaxObstacles = FMath::RoundToInt(GridRows * GridColumns * (ObstaclePercentage / 100.0f));
+    UE_LOG(LogTemp, Warning, TEXT("Generated %d obstacles out of a maximum of %d requested."), Layout.PlacedObstacles, MaxObstacles);
+
+    // Nessuna cella  occupata all'inizio della partita
+    const int32 NumCells = GetNumCells();
+    CellOccupied.Init(false, NumCells);
+    CellUnits.Init(nullptr, NumCells);
+    WalkableBits.Init(GridRows, GridColumns);
+    for (int32 Index = 0; Index < NumCells; Index++)
+    {
+        WalkableBits.SetTo(Index, !CellObstacles[Index]);
+    }
+
+    ChunkCountX = FMath::DivideAndRoundUp(GridColumns, ChunkSize);
+    ChunkCountY = FMath::DivideAndRoundUp(GridRows, ChunkSize);
+    const int32 NumChunks = ChunkCountX * ChunkCountY;
+
+    CreateHighlightResources();
+
+    if (IsStreamed())
+    {
+        ChunkComponents.Init(nullptr, NumChunks * 3);
+        ChunkLoaded.Init(false, NumChunks);
+        LoadedChunks.Reset();
+    }
+    else if (IsInstanced())
+    {
+        UInstancedStaticMeshComponent* Components[] = { NormalCellsISM, TreeCellsISM, MountainCellsISM };
+        for (int32 i = 0; i < UE_ARRAY_COUNT(Components); i++)
         {
-            if (!GridObstacles[Row][Col])
+            Components[i]->ClearInstances();
+            if (UMaterialInterface* Material = GetCellMaterial(static_cast<EGridCellVisual>(i)))
             {
-                Start = FGridPosition(Col, Row);
-                break;
+                Components[i]->SetMaterial(0, Material);
             }
         }
-        if (Start.X != -1)
+    }
+    else
+    {
+        GridCells.Init(nullptr, NumCells);
+    }
+}
+
+void AGridManager::FinishInitialization()
+{
+    bGridReady = true;
+
+    // Dopo l'inizializzazione il tick serve solo per lo streaming dei chunk
+    SetActorTickEnabled(IsStreamed());
+    if (IsStreamed())
+    {
+        LastStreamingRect = FIntRect();
+        bStreamingPending = true;
+        UpdateStreaming();
+    }
+
+    static const TCHAR* RenderModeNames[] = { TEXT("cell actors"), TEXT("instanced"), TEXT("streamed") };
+    UE_LOG(LogTemp, Log, TEXT("Grid %dx%d ready in %.2f ms (%s)."), GridColumns, GridRows,
+        (FPlatformTime::Seconds() - InitializationStartTime) * 1000.0, RenderModeNames[static_cast<int32>(RenderMode)]);
+
+    OnGridReady.Broadcast();
+}
+
+void AGridManager::SpawnCellActor(int32 Index)
+{
+    FTransform CellTransform;
+    CellTransform.SetLocation(GetCellLocation(Index));
+
+    const EGridCellVisual Visual = CellVisuals[GetTileIndex(Index)];
+    UMaterialInterface* FinalObstacleMat = GetCellMaterial(Visual == EGridCellVisual::Normal ? EGridCellVisual::Tree : Visual);
+
+    // Crea una nuova cella
+    AGridCell* NewCell = GetWorld()->SpawnActor<AGridCell>(GridCellClass, CellTransform);
+    if (NewCell)
+    {
+        // Inizializza la cella con i materiali e la dimensione specificata
+        NewCell->InitializeCell(CellObstacles[Index], CellSize, GetCellMaterial(EGridCellVisual::Normal), FinalObstacleMat);
+
+        NewCell->GridX = GetCellX(Index);
+        NewCell->GridY = GetCellY(Index);
+        NewCell->CellIndex = Index;
+
+        GridCells[Index] = NewCell;
+    }
+}
+
+void AGridManager::AddCellInstances(int32 Begin, int32 End)
+{
+    UInstancedStaticMeshComponent* Components[] = { NormalCellsISM, TreeCellsISM, MountainCellsISM };
+
+    TArray<FTransform> Transforms[UE_ARRAY_COUNT(Components)];
+
+    const FVector MeshScale = CellSize / 100.f;
+
+    for (int32 Index = Begin; Index < End; Index++)
+    {
+        const int32 Visual = static_cast<int32>(CellVisuals[GetTileIndex(Index)]);
+        Transforms[Visual].Add(FTransform(FQuat::Identity, GetCellLocation(Index), MeshScale));
+    }
+
+    for (int32 i = 0; i < UE_ARRAY_COUNT(Components); i++)
+    {
+        if (Transforms[i].Num() > 0)
         {
-            break;
+            Components[i]->AddInstances(Transforms[i], false, true);
         }
     }
+}
 
-    // Se non viene trovata alcuna cella libera, la griglia non  valida
-    if (Start.X == -1)
+int32 AGridManager::GetTileIndex(int32 Index) const
+{
+    return ComputeTileIndex(GetCellX(Index), GetCellY(Index), ChunkSize, ChunkCountX);
+}
+
+int32 AGridManager::ComputeTileIndex(int32 X, int32 Y, int32 InChunkSize, int32 InChunkCountX)
+{
+    const int32 ChunkIndex = (Y / InChunkSize) * InChunkCountX + X / InChunkSize;
+    return ChunkIndex * InChunkSize * InChunkSize + (Y % InChunkSize) * InChunkSize + X % InChunkSize;
+}
+
+// Calcola l'area di chunk inquadrata dalla telecamera (vista dall'alto), carica quelli mancanti
+// e scarica quelli usciti dall'area
+void AGridManager::UpdateStreaming()
+{
+    APlayerController* PC = GetWorld()->GetFirstPlayerController();
+    if (!PC || !PC->PlayerCameraManager || ChunkCountX == 0 || ChunkCountY == 0)
     {
-        return false;
+        return;
     }
 
-    // Trova tutte le celle connesse a partire dalla cella trovata
-    TSet<FGridPosition> ConnectedCells = FindConnectedCells(Start);
+    FVector ViewLocation;
+    FRotator ViewRotation;
+    PC->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+    // Con la telecamera rivolta verso il basso la met del lato inquadrato  altezza * tan(FOV / 2)
+    const float ViewHeight = FMath::Max(ViewLocation.Z, 0.f);
+    const float HalfExtent = ViewHeight * FMath::Tan(FMath::DegreesToRadians(PC->PlayerCameraManager->GetFOVAngle() * 0.5f));
+
+    const FVector OriginOffset = GetGridOriginOffset();
+    const float ChunkWorldX = ChunkSize * (CellSize.X + CellMargin);
+    const float ChunkWorldY = ChunkSize * (CellSize.Y + CellMargin);
+
+    FIntRect Rect;
+    Rect.Min.X = FMath::Max(FMath::FloorToInt((ViewLocation.X - HalfExtent + OriginOffset.X) / ChunkWorldX) - ChunkStreamingMargin, 0);
+    Rect.Min.Y = FMath::Max(FMath::FloorToInt((ViewLocation.Y - HalfExtent + OriginOffset.Y) / ChunkWorldY) - ChunkStreamingMargin, 0);
+    Rect.Max.X = FMath::Min(FMath::FloorToInt((ViewLocation.X + HalfExtent + OriginOffset.X) / ChunkWorldX) + ChunkStreamingMargin, ChunkCountX - 1);
+    Rect.Max.Y = FMath::Min(FMath::FloorToInt((ViewLocation.Y + HalfExtent + OriginOffset.Y) / ChunkWorldY) + ChunkStreamingMargin, ChunkCountY - 1);
+
+    if (Rect == LastStreamingRect && !bStreamingPending)
+    {
+        return;
+    }
+    LastStreamingRect = Rect;
 
-    // Conta il totale delle celle non ostacolo presenti nella griglia
-    int32 TotalNonObstacleCells = 0;
-    for (int32 Row = 0; Row < GridRows; Row++)
+    // Scarica i chunk lontani, lasciando un chunk di tolleranza per non ricaricarli ai bordi dell'area
+    for (int32 i = LoadedChunks.Num() - 1; i >= 0; i--)
     {
-        for (int32 Col = 0; Col < GridColumns; Col++)
+        const int32 ChunkX = LoadedChunks[i] % ChunkCountX;
+        const int32 ChunkY = LoadedChunks[i] / ChunkCountX;
+        if (ChunkX < Rect.Min.X - 1 || ChunkX > Rect.Max.X + 1 || ChunkY < Rect.Min.Y - 1 || ChunkY > Rect.Max.Y + 1)
         {
-            if (!GridObstacles[Row][Col])
+            UnloadChunk(LoadedChunks[i]);
+        }
+    }
+
+    // Carica i chunk mancanti, al massimo MaxChunkLoadsPerFrame per frame
+    int32 LoadBudget = MaxChunkLoadsPerFrame;
+    bStreamingPending = false;
+    for (int32 ChunkY = Rect.Min.Y; ChunkY <= Rect.Max.Y; ChunkY++)
+    {
+        for (int32 ChunkX = Rect.Min.X; ChunkX <= Rect.Max.X; ChunkX++)
+        {
+            const int32 ChunkIndex = ChunkY * ChunkCountX + ChunkX;
+            if (ChunkLoaded[ChunkIndex])
+            {
+                continue;
+            }
+            if (LoadBudget == 0)
             {
-                TotalNonObstacleCells++;
+                bStreamingPending = true;
+                return;
             }
+            LoadChunk(ChunkIndex);
+            LoadBudget--;
+        }
+    }
+}
+
+// Crea le istanze del chunk leggendo il suo blocco contiguo di dati visivi
+void AGridManager::LoadChunk(int32 ChunkIndex)
+{
+    TArray<FTransform> Transforms[3];
+
+    const int32 ChunkX = ChunkIndex % ChunkCountX;
+    const int32 ChunkY = ChunkIndex / ChunkCountX;
+    const int32 TileBase = ChunkIndex * ChunkSize * ChunkSize;
+    const int32 EndX = FMath::Min((ChunkX + 1) * ChunkSize, GridColumns);
+    const int32 EndY = FMath::Min((ChunkY + 1) * ChunkSize, GridRows);
+    const FVector MeshScale = CellSize / 100.f;
+
+    for (int32 Y = ChunkY * ChunkSize; Y < EndY; Y++)
+    {
+        for (int32 X = ChunkX * ChunkSize; X < EndX; X++)
+        {
+            const int32 Tile = TileBase + (Y % ChunkSize) * ChunkSize + X % ChunkSize;
+            const int32 Visual = static_cast<int32>(CellVisuals[Tile]);
+            Transforms[Visual].Add(FTransform(FQuat::Identity, GetCellLocation(Y * GridColumns + X), MeshScale));
         }
     }
 
-    // La griglia  completamente connessa se tutte le celle non ostacolo sono raggiungibili
-    return ConnectedCells.Num() == TotalNonObstacleCells;
+    for (int32 Visual = 0; Visual < 3; Visual++)
+    {
+        if (Transforms[Visual].Num() == 0)
+        {
+            continue;
+        }
+
+        UInstancedStaticMeshComponent* Component = AcquireChunkComponent(static_cast<EGridCellVisual>(Visual));
+        Component->AddInstances(Transforms[Visual], false, true);
+        ChunkComponents[ChunkIndex * 3 + Visual] = Component;
+    }
+
+    ChunkLoaded[ChunkIndex] = true;
+    LoadedChunks.Add(ChunkIndex);
 }
 
-TSet<FGridPosition> AGridManager::FindConnectedCells(const FGridPosition& Start)
+// Rilascia le componenti del chunk, che tornano disponibili per i prossimi chunk da caricare
+void AGridManager::UnloadChunk(int32 ChunkIndex)
 {
-    const int32 dx[] = { 0, 0, -1, 1 };
-    const int32 dy[] = { -1, 1, 0, 0 };
+    for (int32 Visual = 0; Visual < 3; Visual++)
+    {
+        UInstancedStaticMeshComponent*& Component = ChunkComponents[ChunkIndex * 3 + Visual];
+        if (Component)
+        {
+            Component->ClearInstances();
+            FreeChunkComponents.Add(Component);
+            Component = nullptr;
+        }
+    }
 
-    TSet<FGridPosition> Visited;
-    TQueue<FGridPosition> Queue;
+    ChunkLoaded[ChunkIndex] = false;
+    LoadedChunks.RemoveSingleSwap(ChunkIndex);
+}
 
-    Queue.Enqueue(Start);
-    Visited.Add(Start);
+UInstancedStaticMeshComponent* AGridManager::AcquireChunkComponent(EGridCellVisual Visual)
+{
+    UInstancedStaticMeshComponent* Component = FreeChunkComponents.Num() > 0 ? FreeChunkComponents.Pop() : nullptr;
+    if (!Component)
+    {
+        Component = NewObject<UInstancedStaticMeshComponent>(this);
+        Component->SetupAttachment(RootComponent);
+        Component->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+        Component->SetStaticMesh(NormalCellsISM->GetStaticMesh());
+        Component->RegisterComponent();
+    }
+
+    if (UMaterialInterface* Material = GetCellMaterial(Visual))
+    {
+        Component->SetMaterial(0, Material);
+    }
+    return Component;
+}
+
+// Restituisce l'attore della cella in posizione (X, Y) senza scorrere tutta la griglia
+AGridCell* AGridManager::GetCell(int32 X, int32 Y) const
+{
+    const int32 Index = GetCellIndex(X, Y);
+    return GridCells.IsValidIndex(Index) ? GridCells[Index] : nullptr;
+}
+
+// Restituisce i vicini ortogonali della cella calcolandone direttamente gli indici
+FGridNeighbors AGridManager::GetNeighbors(int32 Index) const
+{
+    FGridNeighbors Neighbors;
+    const int32 X = GetCellX(Index);
+    const int32 Y = GetCellY(Index);
+
+    if (Y > 0)
+    {
+        Neighbors.Add(Index - GridColumns);
+    }
+    if (X < GridColumns - 1)
+    {
+        Neighbors.Add(Index + 1);
+    }
+    if (Y < GridRows - 1)
+    {
+        Neighbors.Add(Index + GridColumns);
+    }
+    if (X > 0)
+    {
+        Neighbors.Add(Index - 1);
+    }
+    return Neighbors;
+}
+
+int32 AGridManager::GetDistance(int32 IndexA, int32 IndexB) const
+{
+    return FMath::Abs(GetCellX(IndexA) - GetCellX(IndexB)) + FMath::Abs(GetCellY(IndexA) - GetCellY(IndexB));
+}
+
+// Calcola la posizione della cella includendo il margine e l'offset per centrare la griglia
+FVector AGridManager::GetCellLocation(int32 Index) const
+{
+    const FVector OriginOffset = GetGridOriginOffset();
+
+    return FVector(GetCellX(Index) * (CellSize.X + CellMargin), GetCellY(Index) * (CellSize.Y + CellMargin), 0.f) - OriginOffset;
+}
 
-    while (!Queue.IsEmpty())
+FVector AGridManager::GetGridOriginOffset() const
+{
+    float TotalWidth = GridColumns * CellSize.X;
+    float TotalHeight = GridRows * CellSize.Y;
+    return FVector(TotalWidth / 2.f - CellSize.X / 2.f, TotalHeight / 2.f - CellSize.Y / 2.f, 0.f);
+}
+
+int32 AGridManager::GetCellIndexFromLocation(const FVector& Location) const
+{
+    const FVector OriginOffset = GetGridOriginOffset();
+
+    // Inverte la formula di GetCellLocation: il centro della cella X si trova in X * (CellSize + CellMargin)
+    const float LocalX = (Location.X + OriginOffset.X) / (CellSize.X + CellMargin);
+    const float LocalY = (Location.Y + OriginOffset.Y) / (CellSize.Y + CellMargin);
+    const int32 X = FMath::RoundToInt(LocalX);
+    const int32 Y = FMath::RoundToInt(LocalY);
+
+    // I punti che cadono nel margine tra due celle non appartengono a nessuna cella
+    const float HalfX = 0.5f * CellSize.X / (CellSize.X + CellMargin);
+    const float HalfY = 0.5f * CellSize.Y / (CellSize.Y + CellMargin);
+    if (FMath::Abs(LocalX - X) > HalfX || FMath::Abs(LocalY - Y) > HalfY)
     {
-        FGridPosition Current;
-        Queue.Dequeue(Current);
+        return INDEX_NONE;
+    }
+    return GetCellIndex(X, Y);
+}
 
-        for (int32 Dir = 0; Dir < 4; Dir++)
+int32 AGridManager::GetCellIndexFromRay(const FVector& RayOrigin, const FVector& RayDirection) const
+{
+    // Le celle sono centrate su Z = 0, quindi la faccia superiore si trova a met dell'altezza
+    const float TopZ = CellSize.Z / 2.f;
+    if (FMath::IsNearlyZero(RayDirection.Z))
+    {
+        return INDEX_NONE;
+    }
+
+    const float T = (TopZ - RayOrigin.Z) / RayDirection.Z;
+    if (T < 0.f)
+    {
+        return INDEX_NONE;
+    }
+    return GetCellIndexFromLocation(RayOrigin + RayDirection * T);
+}
+
+// Segna la cella come occupata dall'unit indicata
+void AGridManager::SetCellOccupant(int32 Index, ABaseUnit* Unit)
+{
+    if (!IsValidCell(Index))
+    {
+        return;
+    }
+    CellOccupied[Index] = (Unit != nullptr);
+    CellUnits[Index] = Unit;
+    WalkableBits.SetTo(Index, !CellObstacles[Index] && Unit == nullptr);
+    OccupancyVersion++;
+    Hierarchy.MarkCellChanged(Index);
+
+    // Le ricerche gi avviate continuano sul vecchio snapshot, le prossime ne useranno uno nuovo
+    GridSnapshot.Reset();
+}
+
+// Restituisce l'area in cache per lo stato attuale della griglia oppure la calcola con un riempimento a bit
+// sulle celle libere: ogni strato della BFS  un'operazione su intere righe (vedi FGridBitboard::FloodFill)
+const FGridReachableArea& AGridManager::GetReachableArea(int32 Origin, int32 Range)
+{
+    FGridReachableArea* Area = nullptr;
+    for (FGridReachableArea& Entry : ReachableCache)
+    {
+        if (Entry.Version == OccupancyVersion && Entry.Origin == Origin && Entry.Range == Range)
+        {
+            return Entry;
+        }
+        if (!Area && Entry.Version != OccupancyVersion)
         {
-            int32 NewX = Current.X + dx[Dir];
-            int32 NewY = Current.Y + dy[Dir];
+            Area = &Entry;
+        }
+    }
+    if (!Area)
+    {
+        Area = &ReachableCache.AddDefaulted_GetRef();
+    }
 
-            if (NewX >= 0 && NewX < GridColumns && NewY >= 0 && NewY < GridRows)
-            {
-                FGridPosition NewPos(NewX, NewY);
+    Area->Origin = Origin;
+    Area->Range = Range;
+    Area->Version = OccupancyVersion;
+    if (!IsValidCell(Origin))
+    {
+        Area->Cells.Init(GridRows, GridColumns);
+        Area->Layers.Reset();
+        return *Area;
+    }
+
+    FGridBitboard::FloodFill(WalkableBits, Origin, Range, Area->Cells, Area->Layers);
+    return *Area;
+}
+
+bool AGridManager::GetCachedPath(int32 Origin, int32 Goal, TArray<int32>& OutPath) const
+{
+    OutPath.Reset();
+
+    for (const FGridReachableArea& Entry : ReachableCache)
+    {
+        if (Entry.Version != OccupancyVersion || Entry.Origin != Origin || !IsValidCell(Goal) || !Entry.Cells.Test(Goal))
+        {
+            continue;
+        }
+
+        // Dallo strato dell'obiettivo scende di uno strato alla volta verso la partenza, che  l'unica cella dello strato 0
+        int32 Distance = 1;
+        while (!Entry.Layers[Distance].Test(Goal))
+        {
+            Distance++;
+        }
 
-                if (!GridObstacles[NewY][NewX] && !Visited.Contains(NewPos))
+        int32 Cell = Goal;
+        OutPath.Add(Cell);
+        for (int32 Layer = Distance - 1; Layer >= 0; Layer--)
+        {
+            for (int32 Neighbor : GetNeighbors(Cell))
+            {
+                if (Entry.Layers[Layer].Test(Neighbor))
                 {
-                    Queue.Enqueue(NewPos);
-                    Visited.Add(NewPos);
+                    Cell = Neighbor;
+                    break;
                 }
             }
+            OutPath.Add(Cell);
         }
+        Algo::Reverse(OutPath);
+        return true;
     }
+    return false;
+}
 
-    return Visited;
+void AGridManager::ResetTurnSearchResults()
+{
+    for (FGridReachableArea& Entry : ReachableCache)
+    {
+        Entry.Version = 0;
+    }
 }
 
-void AGridManager::Tick(float DeltaTime)
+// Registra la richiesta sul servizio dei percorsi, creando lo snapshot della griglia solo se  cambiata
+int32 AGridManager::RequestPath(int32 Start, int32 Goal, int32 MaxCost, FOnGridPathReady Callback)
 {
-    Super::Tick(DeltaTime);
+    if (!GridSnapshot.IsValid() || GridSnapshot->Algorithm != PathAlgorithm)
+    {
+        TSharedRef<FGridSnapshot> Snapshot = MakeShared<FGridSnapshot>();
+        Snapshot->Rows = GridRows;
+        Snapshot->Columns = GridColumns;
+        Snapshot->Obstacles = CellObstacles;
+        Snapshot->Occupied = CellOccupied;
+        Snapshot->Algorithm = PathAlgorithm;
+
+        // Sulle griglie grandi le ricerche usano una copia del grafo gerarchico, con i cluster gi aggiornati
+        if (Hierarchy.IsBuilt())
+        {
+            Hierarchy.UpdateDirtyClusters(CellObstacles, CellOccupied);
+            Snapshot->Hierarchy = MakeShared<FGridHierarchy>(Hierarchy);
+        }
+        GridSnapshot = Snapshot;
+    }
+
+    SetActorTickEnabled(true);
+    return PathService.RequestPath(GridSnapshot.ToSharedRef(), Start, Goal, MaxCost, MoveTemp(Callback));
 }
 
-AGridManager* AGridManager::GetInstance(UWorld* World)
+void AGridManager::CancelPathRequest(int32 Handle)
 {
-    if (!Instance)
+    PathService.CancelRequest(Handle);
+}
+
+// Libera la cella
+void AGridManager::ClearCellOccupant(int32 Index)
+{
+    SetCellOccupant(Index, nullptr);
+}
+
+// Evidenzia la cella scrivendo il suo texel nella texture condivisa: nessun materiale viene creato per cella
+// e tutte le modifiche del frame vengono inviate alla GPU insieme nel tick
+void AGridManager::HighlightCell(int32 Index, const FLinearColor& Color)
+{
+    FColor Pixel = Color.ToFColor(false);
+    Pixel.A = 255;
+    SetHighlightPixel(Index, Pixel);
+}
+
+void AGridManager::ResetCellHighlight(int32 Index)
+{
+    SetHighlightPixel(Index, FColor(0, 0, 0, 0));
+}
+
+void AGridManager::SetHighlightPixel(int32 Index, const FColor& Pixel)
+{
+    if (!HighlightPixels.IsValidIndex(Index) || HighlightPixels[Index] == Pixel)
     {
-        // Cerca un'istanza gi esistente nel mondo
-        for (TActorIterator<AGridManager> It(World); It; ++It)
+        return;
+    }
+    HighlightPixels[Index] = Pixel;
+
+    if (!bUseHighlightTexture)
+    {
+        ChangedHighlightCells.Add(Index);
+        if (Pixel.A > 0)
         {
-            Instance = *It;
-            break;
+            HighlightedCells.Add(Index);
         }
-        // Se non viene trovata, crea una nuova istanza
-        if (!Instance)
+        else
         {
-            Instance = World->SpawnActor<AGridManager>(AGridManager::StaticClass(), FTransform::Identity);
+            HighlightedCells.Remove(Index);
         }
     }
-    return Instance;
+
+    const FIntPoint Cell(GetCellX(Index), GetCellY(Index));
+    if (!bHighlightDirty)
+    {
+        HighlightDirtyRect = FIntRect(Cell, Cell + FIntPoint(1, 1));
+        bHighlightDirty = true;
+        SetActorTickEnabled(true);
+    }
+    else
+    {
+        HighlightDirtyRect.Min = HighlightDirtyRect.Min.ComponentMin(Cell);
+        HighlightDirtyRect.Max = HighlightDirtyRect.Max.ComponentMax(Cell + FIntPoint(1, 1));
+    }
 }
 
-// Funzione per inizializzare la griglia: genera ostacoli, calcola offset e crea le celle
-void AGridManager::InitializeGrid()
+void AGridManager::FlushHighlights()
 {
-    UE_LOG(LogTemp, Warning, TEXT("InitializeGrid() called manually."));
+    bHighlightDirty = false;
+    if (!bUseHighlightTexture)
+    {
+        FlushHighlightsWithoutTexture();
+        return;
+    }
+    if (!HighlightTexture)
+    {
+        return;
+    }
 
-    // Verifica che la classe delle celle sia assegnata
-    if (!GridCellClass)
+    // I dati devono restare validi finch il render thread non li ha copiati: vengono liberati nel callback
+    const int32 Width = HighlightDirtyRect.Width();
+    const int32 Height = HighlightDirtyRect.Height();
+    uint8* RegionData = static_cast<uint8*>(FMemory::Malloc(Width * Height * sizeof(FColor)));
+    for (int32 Row = 0; Row < Height; Row++)
     {
-        UE_LOG(LogTemp, Warning, TEXT("GridCellClass has not been assigned in GridManager"));
+        const int32 SourceIndex = (HighlightDirtyRect.Min.Y + Row) * GridColumns + HighlightDirtyRect.Min.X;
+        FMemory::Memcpy(RegionData + Row * Width * sizeof(FColor), &HighlightPixels[SourceIndex], Width * sizeof(FColor));
+    }
+
+    FUpdateTextureRegion2D* Region = new FUpdateTextureRegion2D(HighlightDirtyRect.Min.X, HighlightDirtyRect.Min.Y, 0, 0, Width, Height);
+    HighlightTexture->UpdateTextureRegions(0, 1, Region, Width * sizeof(FColor), sizeof(FColor), RegionData,
+        [](uint8* SrcData, const FUpdateTextureRegion2D* Regions)
+        {
+            FMemory::Free(SrcData);
+            delete Regions;
+        });
+}
+
+// Con gli attori ogni cella cambia il proprio materiale; con le istanze le lastre vengono ricreate, una
+// componente per colore (le celle evidenziate sono poche, le aree di movimento e di attacco di un'unit)
+void AGridManager::FlushHighlightsWithoutTexture()
+{
+    if (!IsInstanced())
+    {
+        for (int32 Index : ChangedHighlightCells)
+        {
+            AGridCell* Cell = GridCells.IsValidIndex(Index) ? GridCells[Index] : nullptr;
+            if (!Cell)
+            {
+                continue;
+            }
+            if (HighlightPixels[Index].A > 0)
+            {
+                Cell->HighlightCell(HighlightPixels[Index].ReinterpretAsLinear());
+            }
+            else
+            {
+                Cell->ResetHighlight();
+            }
+        }
+        ChangedHighlightCells.Reset();
         return;
     }
+    ChangedHighlightCells.Reset();
 
-    // Verifica che i materiali siano stati assegnati
-    if (!NormalMaterial || !ObstacleMaterial)
+    TArray<TArray<FTransform>> Transforms;
+    Transforms.SetNum(HighlightOverlays.Num());
+    const FVector MeshScale = CellSize / 100.f;
+    for (int32 Index : HighlightedCells)
     {
-        UE_LOG(LogTemp, Warning, TEXT("Materials not assigned in GridManager"));
+        const FColor& Pixel = HighlightPixels[Index];
+        int32 Overlay = HighlightOverlayColors.Find(Pixel);
+        if (Overlay == INDEX_NONE)
+        {
+            UInstancedStaticMeshComponent* Component = NewObject<UInstancedStaticMeshComponent>(this);
+            Component->SetupAttachment(RootComponent);
+            Component->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+            Component->SetStaticMesh(NormalCellsISM->GetStaticMesh());
+            Component->RegisterComponent();
+            if (UMaterialInstanceDynamic* Material = NormalMaterial ? UMaterialInstanceDynamic::Create(NormalMaterial, this) : nullptr)
+            {
+                Material->SetVectorParameterValue(TEXT("BaseColor"), Pixel.ReinterpretAsLinear());
+                Component->SetMaterial(0, Material);
+            }
+            Overlay = HighlightOverlays.Add(Component);
+            HighlightOverlayColors.Add(Pixel);
+            Transforms.AddDefaulted();
+        }
+
+        // Lastra sottile appoggiata sulla faccia superiore della cella
+        const FVector Location = GetCellLocation(Index) + FVector(0.f, 0.f, 50.f * MeshScale.Z + 1.f);
+        Transforms[Overlay].Add(FTransform(FQuat::Identity, Location, MeshScale * FVector(0.9f, 0.9f, 0.02f)));
     }
 
-    // Resetta gli array delle celle e degli ostacoli
-    GridCells.Empty();
-    GridObstacles.Empty();
+    for (int32 Overlay = 0; Overlay < HighlightOverlays.Num(); Overlay++)
+    {
+        HighlightOverlays[Overlay]->ClearInstances();
+        if (Transforms[Overlay].Num() > 0)
+        {
+            HighlightOverlays[Overlay]->AddInstances(Transforms[Overlay], false, true);
+        }
+    }
+}
 
-    // Genera gli ostacoli e configura l'array GridObstacles
-    GenerateObstacles();
+// Texture con un texel per cella, senza filtro, e un'istanza dei materiali per ogni aspetto che la legge.
+// Le UV del texel della cella (X, Y) sono ((X + 0.5) / Colonne, (Y + 0.5) / Righe): HighlightBounds contiene
+// l'angolo e le dimensioni della griglia nel mondo, cos UV = (Posizione.XY - Bounds.XY) / Bounds.ZW
+void AGridManager::CreateHighlightResources()
+{
+    HighlightPixels.Init(FColor(0, 0, 0, 0), GetNumCells());
+    bHighlightDirty = false;
+    HighlightedCells.Reset();
+    ChangedHighlightCells.Reset();
+    for (UInstancedStaticMeshComponent* Overlay : HighlightOverlays)
+    {
+        Overlay->ClearInstances();
+    }
 
-    // Calcola la dimensione totale della griglia e l'offset per centrarla
-    float TotalWidth = GridColumns * CellSize.X;
-    float TotalHeight = GridRows * CellSize.Y;
-    FVector OriginOffset = FVector(TotalWidth / 2.f - CellSize.X / 2.f, TotalHeight / 2.f - CellSize.Y / 2.f, 0.f);
+    UMaterialInterface* BaseMaterials[] = { NormalMaterial, ObstacleMaterial, MountainMaterial ? MountainMaterial : ObstacleMaterial };
 
-    for (int32 Row = 0; Row < GridRows; Row++)
+    // La texture serve solo se tutti i materiali la leggono; altrimenti le celle usano i materiali di base
+    bUseHighlightTexture = true;
+    for (UMaterialInterface* BaseMaterial : BaseMaterials)
     {
-        for (int32 Col = 0; Col < GridColumns; Col++)
+        UTexture* CurrentTexture = nullptr;
+        if (BaseMaterial && !BaseMaterial->GetTextureParameterValue(FHashedMaterialParameterInfo(TEXT("HighlightTexture")), CurrentTexture))
         {
-            // Definisce il margine tra le celle
-            float CellMargin = 10.f;
+            bUseHighlightTexture = false;
+        }
+    }
+    if (!bUseHighlightTexture)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Cell materials have no HighlightTexture parameter: highlights use per-cell materials"));
+        HighlightTexture = nullptr;
+        CellMaterials = TArray<UMaterialInterface*>(BaseMaterials, UE_ARRAY_COUNT(BaseMaterials));
+        return;
+    }
 
-            // Calcola la posizione della cella includendo il margine e l'offset
-            FVector CellLocation = FVector(Col * (CellSize.X + CellMargin), Row * (CellSize.Y + CellMargin), 0.f) - OriginOffset;
+    HighlightTexture = UTexture2D::CreateTransient(GridColumns, GridRows, PF_B8G8R8A8);
+    if (HighlightTexture)
+    {
+        HighlightTexture->Filter = TF_Nearest;
+        HighlightTexture->SRGB = false;
+        HighlightTexture->AddressX = TA_Clamp;
+        HighlightTexture->AddressY = TA_Clamp;
 
-            FTransform CellTransform;
-            CellTransform.SetLocation(CellLocation);
+        FTexture2DMipMap& Mip = HighlightTexture->GetPlatformData()->Mips[0];
+        void* MipData = Mip.BulkData.Lock(LOCK_READ_WRITE);
+        FMemory::Memzero(MipData, GetNumCells() * sizeof(FColor));
+        Mip.BulkData.Unlock();
 
-            bool bIsObstacle = GridObstacles[Row][Col];
+        HighlightTexture->UpdateResource();
+    }
 
-            // Seleziona il materiale ostacolo, ci sono due tipi di ostacolo e materiale: alberi e montagne (distribuite in modo casuale)
-            UMaterialInterface* FinalObstacleMat = ObstacleMaterial;
+    const FVector OriginOffset = GetGridOriginOffset();
+    const FVector2D Pitch(CellSize.X + CellMargin, CellSize.Y + CellMargin);
+    const FLinearColor Bounds(-OriginOffset.X - Pitch.X / 2.f, -OriginOffset.Y - Pitch.Y / 2.f, Pitch.X * GridColumns, Pitch.Y * GridRows);
 
-            if (bIsObstacle && MountainMaterial && FMath::RandBool())
-            {
-                FinalObstacleMat = MountainMaterial;
-            }
+    CellMaterials.Reset();
+    for (UMaterialInterface* BaseMaterial : BaseMaterials)
+    {
+        UMaterialInstanceDynamic* Material = BaseMaterial ? UMaterialInstanceDynamic::Create(BaseMaterial, this) : nullptr;
+        if (Material)
+        {
+            Material->SetTextureParameterValue(TEXT("HighlightTexture"), HighlightTexture);
+            Material->SetVectorParameterValue(TEXT("HighlightBounds"), Bounds);
+        }
+        CellMaterials.Add(Material);
+    }
+}
 
-            // Crea una nuova cella
-            AGridCell* NewCell = GetWorld()->SpawnActor<AGridCell>(GridCellClass, CellTransform);
-            if (NewCell)
-            {
-                // Inizializza la cella con i materiali e la dimensione specificata
-                NewCell->InitializeCell(bIsObstacle, CellSize, NormalMaterial, FinalObstacleMat);
+UMaterialInterface* AGridManager::GetCellMaterial(EGridCellVisual Visual) const
+{
+    const int32 VisualIndex = static_cast<int32>(Visual);
+    return CellMaterials.IsValidIndex(VisualIndex) ? CellMaterials[VisualIndex] : nullptr;
+}
 
-                NewCell->GridX = Col;
-                NewCell->GridY = Row;
+// Box informativo della cella: con gli attori  un componente di ogni cella, altrimenti un solo box che viene spostato
+void AGridManager::SetCellHovered(int32 Index, bool bHovered)
+{
+    if (!IsValidCell(Index))
+    {
+        return;
+    }
 
-                GridCells.Add(NewCell);
-            }
+    if (IsInstanced())
+    {
+        if (bHovered)
+        {
+            const FVector MeshScale = CellSize / 100.f;
+            HoverInfoBox->SetWorldLocationAndRotation(GetCellLocation(Index) + FVector(0.f, 0.f, 50.f * MeshScale.Z), FQuat::Identity);
+            HoverInfoBox->SetWorldScale3D(MeshScale * FVector(0.8f, 0.8f, 0.5f));
+        }
+        HoverInfoBox->SetVisibility(bHovered);
+        return;
+    }
+
+    if (GridCells.IsValidIndex(Index) && GridCells[Index])
+    {
+        if (bHovered)
+        {
+            GridCells[Index]->OnCellHovered();
+        }
+        else
+        {
+            GridCells[Index]->OnCellUnhovered();
         }
     }
 }
@@ -269,6 +1083,8 @@ void AGridManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
     Super::EndPlay(EndPlayReason);
 
+    PathService.Reset();
+
     if (Instance == this)
     {
         Instance = nullptr;
@@ -0,0 +1,144 @@
+#include "GridPathService.h"
+#include "GridSearchContext.h"
+#include "Misc/ScopeLock.h"
+
+int32 FGridPathService::RequestPath(const TSharedRef<const FGridSnapshot>& Snapshot, int32 Start, int32 Goal, int32 MaxCost, FOnGridPathReady Callback)
+{
+    const int32 Budget = (MaxCost == INDEX_NONE) ? MAX_int32 : MaxCost;
+    LatestSnapshot = Snapshot;
+
+    // Cerca una ricerca gi registrata con gli stessi estremi sullo stesso snapshot: se non  ancora partita
+    // ne stringe il limite, altrimenti la riusa solo se il suo limite non  pi largo di quello richiesto
+    // (il task la sta leggendo, quindi non va pi modificata); se nessuna va bene ne registra una nuova
+    TSharedPtr<FSearch> Search;
+    for (const TSharedPtr<FSearch>& Existing : Searches)
+    {
+        if (Existing->Start != Start || Existing->Goal != Goal || Existing->Snapshot != Snapshot)
+        {
+            continue;
+        }
+        if (!Existing->bLaunched)
+        {
+            Search = Existing;
+            Search->MaxCost = FMath::Min(Search->MaxCost, Budget);
+            break;
+        }
+        if (Existing->MaxCost <= Budget)
+        {
+            Search = Existing;
+            break;
+        }
+    }
+
+    if (!Search.IsValid())
+    {
+        Search = MakeShared<FSearch>();
+        Search->Start = Start;
+        Search->Goal = Goal;
+        Search->MaxCost = Budget;
+        Search->Snapshot = Snapshot;
+        Searches.Add(Search);
+    }
+
+    FRequest& Request = Requests.AddDefaulted_GetRef();
+    Request.Handle = NextHandle++;
+    Request.MaxCost = Budget;
+    Request.Callback = MoveTemp(Callback);
+    Request.Search = Search;
+    return Request.Handle;
+}
+
+void FGridPathService::CancelRequest(int32 Handle)
+{
+    Requests.RemoveAll([Handle](const FRequest& Request) { return Request.Handle == Handle; });
+}
+
+void FGridPathService::Update()
+{
+    // Le richieste arrivate nello stesso frame con gli stessi estremi sono gi unite: ora partono le ricerche
+    for (const TSharedPtr<FSearch>& Search : Searches)
+    {
+        if (!Search->bLaunched)
+        {
+            // Il task tiene un riferimento alla ricerca, quindi pu finire anche se nel frattempo viene scartata
+            TSharedPtr<FSearch> SearchRef = Search;
+            Search->Task = UE::Tasks::Launch(UE_SOURCE_LOCATION, [SearchRef]()
+            {
+                RunSearch(*SearchRef);
+            });
+            Search->bLaunched = true;
+            LaunchedSearchCount++;
+        }
+    }
+
+    // Le callback possono registrare nuove richieste, quindi quelle pronte vengono tolte dalla lista prima di chiamarle
+    TArray<FRequest> Completed;
+    for (int32 Index = 0; Index < Requests.Num(); Index++)
+    {
+        if (Requests[Index].Search->IsCompleted())
+        {
+            Completed.Add(MoveTemp(Requests[Index]));
+            Requests.RemoveAt(Index);
+            Index--;
+        }
+    }
+
+    // Tiene le ricerche dell'ultimo snapshot (servono alle prossime richieste del turno) e quelle ancora attese
+    Searches.RemoveAll([this](const TSharedPtr<FSearch>& Search)
+    {
+        if (Search->Snapshot == LatestSnapshot)
+        {
+            return false;
+        }
+        return !Requests.ContainsByPredicate([&Search](const FRequest& Request) { return Request.Search == Search; });
+    });
+
+    TArray<int32> Path;
+    for (FRequest& Request : Completed)
+    {
+        BuildPath(*Request.Search, Request.MaxCost, Path);
+        Request.Callback.ExecuteIfBound(Path);
+    }
+}
+
+void FGridPathService::Reset()
+{
+    Requests.Empty();
+    Searches.Empty();
+    LatestSnapshot.Reset();
+}
+
+void FGridPathService::RunSearch(FSearch& Search)
+{
+    const FGridSnapshot& Snapshot = *Search.Snapshot;
+    const int32 TotalCells = Snapshot.Rows * Snapshot.Columns;
+    if (Search.Start < 0 || Search.Start >= TotalCells || Search.Goal < 0 || Search.Goal >= TotalCells)
+    {
+        return;
+    }
+
+    // Ogni task ha i propri buffer: quelli del GridManager sono del game thread
+    FGridSearchContext Context;
+    if (Snapshot.Hierarchy.IsValid())
+    {
+        FScopeLock Lock(&Snapshot.HierarchyLock);
+        Snapshot.Hierarchy->FindPath(Snapshot.Obstacles, Snapshot.Occupied, Search.Start, Search.Goal, Context, Search.Path);
+
+        // Il percorso gerarchico  quasi minimo: se supera il limite decide la ricerca esatta sulla griglia
+        if (Search.Path.Num() > 0 && Search.Path.Num() - 1 <= Search.MaxCost)
+        {
+            return;
+        }
+    }
+    FGridPathfinder::FindPath(Snapshot.Rows, Snapshot.Columns, Snapshot.Obstacles, Snapshot.Occupied, Search.Start, Search.Goal, Context, Search.Path, Snapshot.Algorithm);
+}
+
+void FGridPathService::BuildPath(const FSearch& Search, int32 MaxCost, TArray<int32>& OutPath)
+{
+    // Il percorso include la partenza: i passi sono uno in meno delle celle
+    OutPath.Reset();
+    if (Search.Path.Num() > 0 && Search.Path.Num() - 1 <= MaxCost)
+    {
+        OutPath = Search.Path;
+    }
+}
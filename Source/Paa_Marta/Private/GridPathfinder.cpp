@@ -0,0 +1,489 @@
+#include "GridPathfinder.h"
+#include "GridSearchContext.h"
+#include "GridGenerator.h"
+#include "Algo/Reverse.h"
+#include "Containers/Queue.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+
+namespace
+{
+    // Direzioni dei 4 vicini ortogonali
+    const int32 DirX[] = { 0, 1, 0, -1 };
+    const int32 DirY[] = { -1, 0, 1, 0 };
+
+    // Comando da console per lanciare il benchmark: Paa.BenchmarkPathfinding [Size1 Size2 ...]
+    FAutoConsoleCommand PathfindingBenchmarkCommand(
+        TEXT("Paa.BenchmarkPathfinding"),
+        TEXT("Compares A* with the previous BFS pathfinding. Usage: Paa.BenchmarkPathfinding [Size1 Size2 ...]"),
+        FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+        {
+            TArray<int32> GridSizes;
+            for (const FString& Arg : Args)
+            {
+                int32 Size = FCString::Atoi(*Arg);
+                if (Size > 0)
+                {
+                    GridSizes.Add(Size);
+                }
+            }
+            if (GridSizes.Num() == 0)
+            {
+                GridSizes = { 25, 100, 500 };
+            }
+            FGridPathfinder::RunBenchmark(GridSizes, 50, 12345);
+        }));
+
+    // Comando da console per il confronto con la Jump Point Search: Paa.BenchmarkJumpPoint [Size1 Size2 ...]
+    FAutoConsoleCommand JumpPointBenchmarkCommand(
+        TEXT("Paa.BenchmarkJumpPoint"),
+        TEXT("Compares A* with Jump Point Search on generated maps. Usage: Paa.BenchmarkJumpPoint [Size1 Size2 ...]"),
+        FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+        {
+            TArray<int32> GridSizes;
+            for (const FString& Arg : Args)
+            {
+                int32 Size = FCString::Atoi(*Arg);
+                if (Size > 0)
+                {
+                    GridSizes.Add(Size);
+                }
+            }
+            if (GridSizes.Num() == 0)
+            {
+                GridSizes = { 25, 50, 100, 200, 400 };
+            }
+            FGridPathfinder::RunJumpPointBenchmark(GridSizes, 100, 12345);
+        }));
+
+    // Salti rettilinei della Jump Point Search: ogni salto restituisce il primo punto di svolta incontrato
+    // oppure INDEX_NONE se il tratto finisce contro un ostacolo o il bordo senza trovarne
+    struct FJumpGrid
+    {
+        int32 Rows;
+        int32 Columns;
+        const TArray<bool>& Obstacles;
+        const TArray<bool>& Occupied;
+        int32 Goal;
+
+        FORCEINLINE bool IsPassable(int32 X, int32 Y) const
+        {
+            if (X < 0 || X >= Columns || Y < 0 || Y >= Rows)
+            {
+                return false;
+            }
+            const int32 Cell = Y * Columns + X;
+            return !Obstacles[Cell] && (!Occupied[Cell] || Cell == Goal);
+        }
+
+        // Un tratto verticale si ferma dove si apre una cella laterale che dalla riga precedente non era raggiungibile
+        int32 JumpVertical(int32 X, int32 Y, int32 DY) const
+        {
+            while (true)
+            {
+                Y += DY;
+                if (!IsPassable(X, Y))
+                {
+                    return INDEX_NONE;
+                }
+                const int32 Cell = Y * Columns + X;
+                if (Cell == Goal
+                    || (IsPassable(X - 1, Y) && !IsPassable(X - 1, Y - DY))
+                    || (IsPassable(X + 1, Y) && !IsPassable(X + 1, Y - DY)))
+                {
+                    return Cell;
+                }
+            }
+        }
+
+        // Un tratto orizzontale si ferma dove uno dei due salti verticali trova un punto di svolta
+        int32 JumpHorizontal(int32 X, int32 Y, int32 DX) const
+        {
+            while (true)
+            {
+                X += DX;
+                if (!IsPassable(X, Y))
+                {
+                    return INDEX_NONE;
+                }
+                const int32 Cell = Y * Columns + X;
+                if (Cell == Goal || JumpVertical(X, Y, -1) != INDEX_NONE || JumpVertical(X, Y, 1) != INDEX_NONE)
+                {
+                    return Cell;
+                }
+            }
+        }
+    };
+}
+
+bool FGridPathfinder::FindPath(int32 Rows, int32 Columns, const TArray<bool>& Obstacles, const TArray<bool>& Occupied,
+    int32 Start, int32 Goal, FGridSearchContext& Context, TArray<int32>& OutPath, EGridPathAlgorithm Algorithm)
+{
+    if (Algorithm == EGridPathAlgorithm::JumpPoint)
+    {
+        return FindPathJumpPoint(Rows, Columns, Obstacles, Occupied, Start, Goal, Context, OutPath);
+    }
+
+    OutPath.Reset();
+
+    const int32 TotalCells = Rows * Columns;
+    if (Start < 0 || Start >= TotalCells || Goal < 0 || Goal >= TotalCells)
+    {
+        return false;
+    }
+
+    const int32 GoalX = Goal % Columns;
+    const int32 GoalY = Goal / Columns;
+
+    Context.BeginSearch(TotalCells);
+    FGridOpenList Open(Context);
+
+    Context.Visit(Start, INDEX_NONE, 0);
+    Context.Score[Start] = FMath::Abs(Start % Columns - GoalX) + FMath::Abs(Start / Columns - GoalY);
+    Context.HeapSlot[Start] = INDEX_NONE;
+    Open.PushOrUpdate(Start);
+
+    while (!Open.IsEmpty())
+    {
+        const int32 Current = Open.Pop();
+        if (Current == Goal)
+        {
+            // Ricostruisce il percorso all'indietro e lo inverte, senza inserimenti in testa
+            for (int32 Cell = Goal; Cell != INDEX_NONE; Cell = Context.GetParent(Cell))
+            {
+                OutPath.Add(Cell);
+            }
+            Algo::Reverse(OutPath);
+            return true;
+        }
+
+        const int32 CurrentX = Current % Columns;
+        const int32 CurrentY = Current / Columns;
+        const int32 NextG = Context.GetCost(Current) + 1;
+
+        // Vicini calcolati direttamente dall'indice
+        for (int32 Dir = 0; Dir < 4; Dir++)
+        {
+            const int32 NewX = CurrentX + DirX[Dir];
+            const int32 NewY = CurrentY + DirY[Dir];
+            if (NewX < 0 || NewX >= Columns || NewY < 0 || NewY >= Rows)
+            {
+                continue;
+            }
+
+            const int32 Neighbor = NewY * Columns + NewX;
+            if (Obstacles[Neighbor] || (Occupied[Neighbor] && Neighbor != Goal))
+            {
+                continue;
+            }
+
+            if (!Context.IsVisited(Neighbor))
+            {
+                Context.Visit(Neighbor, Current, NextG);
+                Context.HeapSlot[Neighbor] = INDEX_NONE;
+            }
+            else if (Context.HeapSlot[Neighbor] == FGridSearchContext::ClosedSlot || NextG >= Context.GetCost(Neighbor))
+            {
+                continue;
+            }
+            else
+            {
+                Context.SetParentAndCost(Neighbor, Current, NextG);
+            }
+
+            Context.Score[Neighbor] = NextG + FMath::Abs(NewX - GoalX) + FMath::Abs(NewY - GoalY);
+            Open.PushOrUpdate(Neighbor);
+        }
+    }
+
+    return false;
+}
+
+bool FGridPathfinder::FindPathJumpPoint(int32 Rows, int32 Columns, const TArray<bool>& Obstacles, const TArray<bool>& Occupied,
+    int32 Start, int32 Goal, FGridSearchContext& Context, TArray<int32>& OutPath)
+{
+    OutPath.Reset();
+
+    const int32 TotalCells = Rows * Columns;
+    if (Start < 0 || Start >= TotalCells || Goal < 0 || Goal >= TotalCells)
+    {
+        return false;
+    }
+
+    const FJumpGrid Grid{ Rows, Columns, Obstacles, Occupied, Goal };
+    const int32 GoalX = Goal % Columns;
+    const int32 GoalY = Goal / Columns;
+
+    Context.BeginSearch(TotalCells);
+    FGridOpenList Open(Context);
+
+    Context.Visit(Start, INDEX_NONE, 0);
+    Context.Score[Start] = FMath::Abs(Start % Columns - GoalX) + FMath::Abs(Start / Columns - GoalY);
+    Context.HeapSlot[Start] = INDEX_NONE;
+    Open.PushOrUpdate(Start);
+
+    // I punti di svolta sono sulla stessa riga o colonna del genitore: il costo del salto  la distanza Manhattan
+    auto Relax = [&](int32 From, int32 JumpPoint)
+    {
+        if (JumpPoint == INDEX_NONE)
+        {
+            return;
+        }
+        const int32 JumpX = JumpPoint % Columns;
+        const int32 JumpY = JumpPoint / Columns;
+        const int32 NewCost = Context.GetCost(From) + FMath::Abs(JumpX - From % Columns) + FMath::Abs(JumpY - From / Columns);
+        if (!Context.IsVisited(JumpPoint))
+        {
+            Context.Visit(JumpPoint, From, NewCost);
+            Context.HeapSlot[JumpPoint] = INDEX_NONE;
+        }
+        else if (Context.HeapSlot[JumpPoint] == FGridSearchContext::ClosedSlot || NewCost >= Context.GetCost(JumpPoint))
+        {
+            return;
+        }
+        else
+        {
+            Context.SetParentAndCost(JumpPoint, From, NewCost);
+        }
+        Context.Score[JumpPoint] = NewCost + FMath::Abs(JumpX - GoalX) + FMath::Abs(JumpY - GoalY);
+        Open.PushOrUpdate(JumpPoint);
+    };
+
+    while (!Open.IsEmpty())
+    {
+        const int32 Current = Open.Pop();
+        if (Current == Goal)
+        {
+            // Riempie i tratti rettilinei tra un punto di svolta e il suo genitore, poi inverte
+            for (int32 Cell = Goal; Cell != Start; Cell = Context.GetParent(Cell))
+            {
+                const int32 ParentCell = Context.GetParent(Cell);
+                const int32 Step = (FMath::Abs(ParentCell - Cell) < Columns) ? (ParentCell > Cell ? 1 : -1) : (ParentCell > Cell ? Columns : -Columns);
+                for (int32 Between = Cell; Between != ParentCell; Between += Step)
+                {
+                    OutPath.Add(Between);
+                }
+            }
+            OutPath.Add(Start);
+            Algo::Reverse(OutPath);
+            return true;
+        }
+
+        const int32 X = Current % Columns;
+        const int32 Y = Current / Columns;
+        const int32 ParentCell = Context.GetParent(Current);
+
+        // Dalla partenza si salta in tutte le direzioni
+        if (ParentCell == INDEX_NONE)
+        {
+            Relax(Current, Grid.JumpHorizontal(X, Y, 1));
+            Relax(Current, Grid.JumpHorizontal(X, Y, -1));
+            Relax(Current, Grid.JumpVertical(X, Y, 1));
+            Relax(Current, Grid.JumpVertical(X, Y, -1));
+            continue;
+        }
+
+        const int32 DX = FMath::Clamp(X - ParentCell % Columns, -1, 1);
+        const int32 DY = FMath::Clamp(Y - ParentCell / Columns, -1, 1);
+        if (DX != 0)
+        {
+            // Arrivati in orizzontale: si prosegue e si pu girare in entrambe le direzioni verticali
+            Relax(Current, Grid.JumpHorizontal(X, Y, DX));
+            Relax(Current, Grid.JumpVertical(X, Y, 1));
+            Relax(Current, Grid.JumpVertical(X, Y, -1));
+        }
+        else
+        {
+            // Arrivati in verticale: si prosegue e si gira solo verso i lati appena aperti
+            Relax(Current, Grid.JumpVertical(X, Y, DY));
+            if (Grid.IsPassable(X - 1, Y) && !Grid.IsPassable(X - 1, Y - DY))
+            {
+                Relax(Current, Grid.JumpHorizontal(X, Y, -1));
+            }
+            if (Grid.IsPassable(X + 1, Y) && !Grid.IsPassable(X + 1, Y - DY))
+            {
+                Relax(Current, Grid.JumpHorizontal(X, Y, 1));
+            }
+        }
+    }
+
+    return false;
+}
+
+bool FGridPathfinder::FindPathBFS(int32 Rows, int32 Columns, const TArray<bool>& Obstacles, const TArray<bool>& Occupied,
+    int32 Start, int32 Goal, TArray<int32>& OutPath)
+{
+    OutPath.Reset();
+
+    TQueue<int32> Frontier;
+    TMap<int32, int32> CameFrom;
+    Frontier.Enqueue(Start);
+    CameFrom.Add(Start, INDEX_NONE);
+
+    while (!Frontier.IsEmpty())
+    {
+        int32 Current = INDEX_NONE;
+        Frontier.Dequeue(Current);
+
+        if (Current == Goal)
+        {
+            break;
+        }
+
+        const int32 CurrentX = Current % Columns;
+        const int32 CurrentY = Current / Columns;
+        for (int32 Dir = 0; Dir < 4; Dir++)
+        {
+            const int32 NewX = CurrentX + DirX[Dir];
+            const int32 NewY = CurrentY + DirY[Dir];
+            if (NewX < 0 || NewX >= Columns || NewY < 0 || NewY >= Rows)
+            {
+                continue;
+            }
+
+            const int32 Neighbor = NewY * Columns + NewX;
+            if (!Obstacles[Neighbor] && (!Occupied[Neighbor] || Neighbor == Goal) && !CameFrom.Contains(Neighbor))
+            {
+                Frontier.Enqueue(Neighbor);
+                CameFrom.Add(Neighbor, Current);
+            }
+        }
+    }
+
+    if (!CameFrom.Contains(Goal))
+    {
+        return false;
+    }
+
+    int32 Current = Goal;
+    while (Current != INDEX_NONE)
+    {
+        OutPath.Insert(Current, 0);
+        Current = CameFrom.FindRef(Current);
+    }
+    return true;
+}
+
+// Stampa nel log il tempo medio per ricerca di A* e della BFS precedente sulle stesse coppie di celle,
+// scelte a caso tra le celle libere di una mappa generata con il seed indicato
+void FGridPathfinder::RunBenchmark(const TArray<int32>& GridSizes, int32 QueriesPerSize, int32 Seed)
+{
+    UE_LOG(LogTemp, Warning, TEXT("Pathfinding benchmark, %d queries per size, seed %d"), QueriesPerSize, Seed);
+
+    for (int32 Size : GridSizes)
+    {
+        FRandomStream Stream(Seed);
+        TArray<bool> Obstacles;
+        FGridObstacleGenerator::GenerateObstacles(Size, Size, 20.0f, Stream, Obstacles);
+
+        TArray<bool> Occupied;
+        Occupied.Init(false, Size * Size);
+
+        TArray<int32> FreeCells;
+        for (int32 Index = 0; Index < Obstacles.Num(); Index++)
+        {
+            if (!Obstacles[Index])
+            {
+                FreeCells.Add(Index);
+            }
+        }
+
+        TArray<TPair<int32, int32>> Queries;
+        for (int32 i = 0; i < QueriesPerSize; i++)
+        {
+            Queries.Add(TPair<int32, int32>(FreeCells[Stream.RandRange(0, FreeCells.Num() - 1)], FreeCells[Stream.RandRange(0, FreeCells.Num() - 1)]));
+        }
+
+        // Il contesto viene riscaldato dalla prima ricerca: le allocazioni contate sono quelle delle ricerche successive
+        FGridSearchContext Context;
+        TArray<int32> Path;
+        TArray<int32> AStarLengths;
+        AStarLengths.Reserve(Queries.Num());
+        FindPath(Size, Size, Obstacles, Occupied, Queries[0].Key, Queries[0].Value, Context, Path);
+        const int64 WarmAllocations = Context.GetTotalAllocations();
+
+        double StartTime = FPlatformTime::Seconds();
+        for (const TPair<int32, int32>& Query : Queries)
+        {
+            FindPath(Size, Size, Obstacles, Occupied, Query.Key, Query.Value, Context, Path);
+            AStarLengths.Add(Path.Num());
+        }
+        const double AStarMs = (FPlatformTime::Seconds() - StartTime) * 1000.0 / Queries.Num();
+        const int64 AStarAllocations = Context.GetTotalAllocations() - WarmAllocations;
+
+        bool bSameLengths = true;
+        StartTime = FPlatformTime::Seconds();
+        for (int32 i = 0; i < Queries.Num(); i++)
+        {
+            FindPathBFS(Size, Size, Obstacles, Occupied, Queries[i].Key, Queries[i].Value, Path);
+            bSameLengths &= (Path.Num() == AStarLengths[i]);
+        }
+        const double BFSMs = (FPlatformTime::Seconds() - StartTime) * 1000.0 / Queries.Num();
+
+        UE_LOG(LogTemp, Warning, TEXT("%dx%d: A* %.3f ms/query (%lld allocations after warm-up), previous BFS %.3f ms/query, same path lengths: %s"),
+            Size, Size, AStarMs, AStarAllocations, BFSMs, bSameLengths ? TEXT("yes") : TEXT("no"));
+    }
+}
+
+// Stampa nel log, per ogni dimensione, nodi espansi e tempo medio di A* e Jump Point Search sulle stesse coppie
+// di celle libere di una mappa generata con GenerateObstacles, e se le lunghezze dei percorsi coincidono
+void FGridPathfinder::RunJumpPointBenchmark(const TArray<int32>& GridSizes, int32 QueriesPerSize, int32 Seed)
+{
+    UE_LOG(LogTemp, Warning, TEXT("Jump Point Search benchmark, %d queries per size, seed %d"), QueriesPerSize, Seed);
+
+    for (int32 Size : GridSizes)
+    {
+        FRandomStream Stream(Seed);
+        TArray<bool> Obstacles;
+        FGridObstacleGenerator::GenerateObstacles(Size, Size, 20.0f, Stream, Obstacles);
+
+        TArray<bool> Occupied;
+        Occupied.Init(false, Size * Size);
+
+        TArray<int32> FreeCells;
+        for (int32 Index = 0; Index < Obstacles.Num(); Index++)
+        {
+            if (!Obstacles[Index])
+            {
+                FreeCells.Add(Index);
+            }
+        }
+
+        TArray<TPair<int32, int32>> Queries;
+        for (int32 i = 0; i < QueriesPerSize; i++)
+        {
+            Queries.Add(TPair<int32, int32>(FreeCells[Stream.RandRange(0, FreeCells.Num() - 1)], FreeCells[Stream.RandRange(0, FreeCells.Num() - 1)]));
+        }
+
+        FGridSearchContext Context;
+        TArray<int32> Path;
+        TArray<int32> AStarLengths;
+        AStarLengths.Reserve(Queries.Num());
+        FindPath(Size, Size, Obstacles, Occupied, Queries[0].Key, Queries[0].Value, Context, Path);
+
+        int64 AStarExpanded = 0;
+        double StartTime = FPlatformTime::Seconds();
+        for (const TPair<int32, int32>& Query : Queries)
+        {
+            FindPath(Size, Size, Obstacles, Occupied, Query.Key, Query.Value, Context, Path, EGridPathAlgorithm::AStar);
+            AStarExpanded += Context.GetLastSearchExpansions();
+            AStarLengths.Add(Path.Num());
+        }
+        const double AStarMs = (FPlatformTime::Seconds() - StartTime) * 1000.0 / Queries.Num();
+
+        int64 JumpPointExpanded = 0;
+        bool bSameLengths = true;
+        StartTime = FPlatformTime::Seconds();
+        for (int32 i = 0; i < Queries.Num(); i++)
+        {
+            FindPath(Size, Size, Obstacles, Occupied, Queries[i].Key, Queries[i].Value, Context, Path, EGridPathAlgorithm::JumpPoint);
+            JumpPointExpanded += Context.GetLastSearchExpansions();
+            bSameLengths &= (Path.Num() == AStarLengths[i]);
+        }
+        const double JumpPointMs = (FPlatformTime::Seconds() - StartTime) * 1000.0 / Queries.Num();
+
+        UE_LOG(LogTemp, Warning, TEXT("%dx%d: A* %.3f ms/query (%lld nodes expanded), JPS %.3f ms/query (%lld nodes expanded), same path lengths: %s"),
+            Size, Size, AStarMs, AStarExpanded / Queries.Num(), JumpPointMs, JumpPointExpanded / Queries.Num(), bSameLengths ? TEXT("yes") : TEXT("no"));
+    }
+}
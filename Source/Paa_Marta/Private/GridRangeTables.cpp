@@ -0,0 +1,36 @@
+#include "GridRangeTables.h"
+
+namespace
+{
+    constexpr TGridDiamond<1> Diamond1;
+    constexpr TGridDiamond<3> Diamond3;
+    constexpr TGridDiamond<6> Diamond6;
+    constexpr TGridDiamond<10> Diamond10;
+
+    static_assert(TGridDiamond<10>::NumCells == 221, "A diamond of radius R has 2R(R+1)+1 cells");
+    static_assert(Diamond10.OffsetY[0] == -10 && Diamond10.OffsetX[110] == 0 && Diamond10.OffsetY[110] == 0, "Diamond offsets are ordered by row");
+
+    template<int32 Radius>
+    FGridDiamondView MakeView(const TGridDiamond<Radius>& Diamond)
+    {
+        FGridDiamondView View;
+        View.Radius = Radius;
+        View.NumCells = TGridDiamond<Radius>::NumCells;
+        View.HalfWidth = Diamond.HalfWidth;
+        View.OffsetX = Diamond.OffsetX;
+        View.OffsetY = Diamond.OffsetY;
+        return View;
+    }
+}
+
+FGridDiamondView FGridRangeTables::GetDiamond(int32 Radius)
+{
+    switch (Radius)
+    {
+    case 1: return MakeView(Diamond1);
+    case 3: return MakeView(Diamond3);
+    case 6: return MakeView(Diamond6);
+    case 10: return MakeView(Diamond10);
+    default: return FGridDiamondView();
+    }
+}
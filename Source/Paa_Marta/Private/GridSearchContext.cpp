@@ -0,0 +1,44 @@
+#include "GridSearchContext.h"
+
+void FGridSearchContext::CountAllocation()
+{
+    LastSearchAllocations++;
+    TotalAllocations++;
+}
+
+// Ingrandisce i buffer solo se la griglia  pi grande di quelle viste finora, poi cambia timbro
+void FGridSearchContext::BeginSearch(int32 NumCells)
+{
+    LastSearchAllocations = 0;
+    LastSearchExpansions = 0;
+
+    if (VisitStamp.Num() < NumCells)
+    {
+        VisitStamp.Init(0, NumCells);
+        Parent.SetNumUninitialized(NumCells);
+        Cost.SetNumUninitialized(NumCells);
+        Score.SetNumUninitialized(NumCells);
+        HeapSlot.SetNumUninitialized(NumCells);
+        Heap.Reserve(NumCells);
+        Stamp = 0;
+        CountAllocation();
+    }
+
+    if (Frontier.Num() < NumCells)
+    {
+        Frontier.SetNumUninitialized(FMath::RoundUpToPowerOfTwo(NumCells));
+        FrontierMask = Frontier.Num() - 1;
+        CountAllocation();
+    }
+
+    // Al giro del contatore i timbri vecchi potrebbero coincidere con quelli nuovi: si azzera una volta ogni 2^32 ricerche
+    if (++Stamp == 0)
+    {
+        FMemory::Memzero(VisitStamp.GetData(), VisitStamp.Num() * sizeof(uint32));
+        Stamp = 1;
+    }
+
+    FrontierHead = 0;
+    FrontierCount = 0;
+    Heap.Reset();
+}
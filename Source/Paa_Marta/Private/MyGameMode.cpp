@@ -1,9 +1,12 @@
 #include "MyGameMode.h"
 #include "GridManager.h"
+#include "GridFlowField.h"
 #include "GridCell.h"
 #include "SniperUnit.h"
 #include "BrawlerUnit.h"
 #include "Kismet/GameplayStatics.h"
+#include "HAL/PlatformTime.h"
+#include "Async/TaskGraphInterfaces.h"
 
 // Costruttore del GameMode: inizializza la classe HUD, il PlayerController e lo stato iniziale del posizionamento
 AMyGameMode::AMyGameMode()
@@ -22,6 +25,43 @@ AMyGameMode::AMyGameMode()
 
     bGameOver = false; // Partita in corso
     bAITurn = false;
+
+    // Il tick serve solo mentre l'IA pensa in background
+    PrimaryActorTick.bCanEverTick = true;
+    PrimaryActorTick.bStartWithTickEnabled = false;
+
+    AIThinkingTimeMs.Add(EAIDifficulty::Easy, 150.0f);
+    AIThinkingTimeMs.Add(EAIDifficulty::Normal, 600.0f);
+    AIThinkingTimeMs.Add(EAIDifficulty::Hard, 2000.0f);
+}
+
+void AMyGameMode::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    FTacticsPlan Plan;
+    if (AIPlanner.TakePlan(Plan))
+    {
+        SetActorTickEnabled(false);
+        PlayAIPlan(Plan);
+    }
+}
+
+void AMyGameMode::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    AIPlanner.Cancel();
+    Super::EndPlay(EndPlayReason);
+}
+
+void AMyGameMode::SetAIDifficulty(EAIDifficulty NewDifficulty)
+{
+    AIDifficulty = NewDifficulty;
+}
+
+float AMyGameMode::GetAIThinkingTimeMs() const
+{
+    const float* ThinkingTime = AIThinkingTimeMs.Find(AIDifficulty);
+    return ThinkingTime ? FMath::Max(*ThinkingTime, 1.0f) : 500.0f;
 }
 
 // Funzione chiamata all'avvio del gioco: inizializza l'HUD, il GridManager e imposta l'ordine di posizionamento 
@@ -39,17 +79,28 @@ void AMyGameMode::BeginPlay()
         }
     }
 
-    // Inizializza il GridManager
+    // Recupera il GridManager: la griglia viene inizializzata dal suo BeginPlay e creata in pi frame,
+    // quindi il posizionamento parte solo quando  pronta
     GridManager = AGridManager::GetInstance(GetWorld());
     if (!GridManager)
     {
         GridManager = GetWorld()->SpawnActor<AGridManager>(AGridManager::StaticClass(), FTransform::Identity);
-        if (GridManager)
-        {
-            GridManager->InitializeGrid();
-        }
     }
 
+    if (GridManager && !GridManager->IsGridReady())
+    {
+        UpdateMovementMessage("Generating the map...");
+        GridManager->OnGridReady.AddUObject(this, &AMyGameMode::OnGridInitialized);
+    }
+    else
+    {
+        OnGridInitialized();
+    }
+}
+
+// Funzione chiamata quando la griglia  pronta: avvia la fase di posizionamento
+void AMyGameMode::OnGridInitialized()
+{
     // Imposta l'ordine di posizionamento in modo casuale e lo mostra nel widget 
     if (HUD)
     {
@@ -80,10 +131,10 @@ void AMyGameMode::BeginPlay()
 }
 
 // Funzione chiamata quando il cursore inizia a passare sopra una cella (mostra l'anteprima) 
-void AMyGameMode::MoveAIUnitsellHoverBegin(AGridCell* Cell)
+void AMyGameMode::OnCellHoverBegin(int32 CellIndex)
 {
     // Se la cella non  valida,  un ostacolo o  gi occupata, non fa nulla
-    if (!Cell || Cell->bIsObstacle || Cell->bIsOccupied)
+    if (!GridManager || !GridManager->IsValidCell(CellIndex) || !GridManager->IsWalkable(CellIndex))
     {
         return;
     }
@@ -91,10 +142,10 @@ void AMyGameMode::MoveAIUnitsellHoverBegin(AGridCell* Cell)
     switch (CurrentPlacementTurn)
     {
     case EPlacementTurn::PlayerSniper:
-        CreateUnitPreview(EUnitType::Sniper, ETeamType::Player, Cell);
+        CreateUnitPreview(EUnitType::Sniper, ETeamType::Player, CellIndex);
         break;
     case EPlacementTurn::PlayerBrawler:
-        CreateUnitPreview(EUnitType::Brawler, ETeamType::Player, Cell);
+        CreateUnitPreview(EUnitType::Brawler, ETeamType::Player, CellIndex);
         break;
     default:
         break;
@@ -102,7 +153,7 @@ void AMyGameMode::MoveAIUnitsellHoverBegin(AGridCell* Cell)
 }
 
 // Funzione chiamata quando il cursore esce da una cella (elimina l'anteprima)
-void AMyGameMode::OnCellHoverEnd(AGridCell* Cell)
+void AMyGameMode::OnCellHoverEnd(int32 CellIndex)
 {
     DestroyUnitPreview();
 }
@@ -110,7 +161,7 @@ void AMyGameMode::OnCellHoverEnd(AGridCell* Cell)
 // Funzione chiamata al click su una cella della griglia
 // Ad ogni turno, ogni unit, sia dell'IA che del giocatore, deve svolgere una delle seguenti azioni:
 // 1. Muoversi 2. Attaccare 3. Muoversi e, se il range di attacco lo consente, anche attaccare
-void AMyGameMode::OnGridCellClicked(AGridCell* Cell)
+void AMyGameMode::OnGridCellClicked(int32 CellIndex)
 {
     if (bGameOver)
     {
@@ -124,13 +175,19 @@ void AMyGameMode::OnGridCellClicked(AGridCell* Cell)
         return;
     }
 
-    if (!Cell)
+    if (!GridManager || !GridManager->IsGridReady())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Grid not ready - click ignored"));
+        return;
+    }
+
+    if (!GridManager->IsValidCell(CellIndex))
     {
-        UE_LOG(LogTemp, Warning, TEXT("Null cell clicked"));
+        UE_LOG(LogTemp, Warning, TEXT("Invalid cell clicked"));
         return;
     }
 
-    if (Cell->bIsObstacle)
+    if (GridManager->IsObstacle(CellIndex))
     {
         UE_LOG(LogTemp, Warning, TEXT("Cannot place unit on an obstacle"));
         return;
@@ -150,13 +207,13 @@ void AMyGameMode::OnGridCellClicked(AGridCell* Cell)
         switch (CurrentPlacementTurn)
         {
         case EPlacementTurn::PlayerSniper:
-            SpawnAndPlaceUnit(EUnitType::Sniper, ETeamType::Player, Cell);
-            HUD->SetExecutionText("HP: S", "Place", GetCellIdentifier(Cell));
+            SpawnAndPlaceUnit(EUnitType::Sniper, ETeamType::Player, CellIndex);
+            HUD->SetExecutionText("HP: S", "Place", GetCellIdentifier(CellIndex));
             AdvancePlacementTurn();
             break;
         case EPlacementTurn::PlayerBrawler:
-            SpawnAndPlaceUnit(EUnitType::Brawler, ETeamType::Player, Cell);
-            HUD->SetExecutionText("HP: B", "Place", GetCellIdentifier(Cell));
+            SpawnAndPlaceUnit(EUnitType::Brawler, ETeamType::Player, CellIndex);
+            HUD->SetExecutionText("HP: B", "Place", GetCellIdentifier(CellIndex));
             AdvancePlacementTurn();
             break;
         default:
@@ -168,13 +225,15 @@ void AMyGameMode::OnGridCellClicked(AGridCell* Cell)
     {
         if (CurrentMovementTurn == EMovementTurn::Player)
         {
+            ABaseUnit* CellUnit = GridManager->GetOccupyingUnit(CellIndex);
+
             // Se nessuna unit  selezionata, tenta di selezionarne una presente nella cella
             if (!SelectedUnitForMovement)
             {
-                if (Cell->OccupyingUnit && Cell->OccupyingUnit->TeamType == ETeamType::Player)
+                if (CellUnit && CellUnit->TeamType == ETeamType::Player)
                 {
-                    UE_LOG(LogTemp, Warning, TEXT("Selecting unit: %s"), *ABaseUnit::GetUnitDescription(Cell->OccupyingUnit));
-                    DisplayUnitRanges(Cell->OccupyingUnit);
+                    UE_LOG(LogTemp, Warning, TEXT("Selecting unit: %s"), *ABaseUnit::GetUnitDescription(CellUnit));
+                    DisplayUnitRanges(CellUnit);
                     return;
                 }
                 else
@@ -184,7 +243,7 @@ void AMyGameMode::OnGridCellClicked(AGridCell* Cell)
                 }
             }
 
-            if (Cell == SelectedUnitForMovement->CurrentCell)
+            if (CellIndex == SelectedUnitForMovement->CurrentCellIndex)
             {
                 UE_LOG(LogTemp, Warning, TEXT("Clicked on current cell; deselecting unit"));
                 ResetAllCellHighlights();
@@ -193,11 +252,11 @@ void AMyGameMode::OnGridCellClicked(AGridCell* Cell)
             }
 
             // Se la cella contiene un'unit nemica, tenta l'attacco
-            if (Cell->OccupyingUnit && Cell->OccupyingUnit->TeamType != ETeamType::Player)
+            if (CellUnit && CellUnit->TeamType != ETeamType::Player)
             {
-                FString TargetCellID = GetCellIdentifier(Cell);
+                FString TargetCellID = GetCellIdentifier(CellIndex);
                 UE_LOG(LogTemp, Warning, TEXT("Attacking enemy unit at cell %s"), *TargetCellID);
-                SelectedUnitForMovement->AttackTarget(Cell->OccupyingUnit);
+                SelectedUnitForMovement->AttackTarget(CellUnit);
                 SelectedUnitForMovement->bHasAttacked = true;
 
                 FString UnitPrefix;
@@ -215,14 +274,15 @@ void AMyGameMode::OnGridCellClicked(AGridCell* Cell)
                 // Se la cella  vuota, tenta il movimento (solo se l'unit non ha gi mosso o attaccato)
                 if (!SelectedUnitForMovement->bHasMoved && !SelectedUnitForMovement->bHasAttacked)
                 {
-                    TSet<AGridCell*> ReachableCells = GetReachableCells(SelectedUnitForMovement);
-                    UE_LOG(LogTemp, Warning, TEXT("Reachable cells count: %d"), ReachableCells.Num());
+                    const FGridBitboard& ReachableCells = GetReachableCells(SelectedUnitForMovement);
+                    UE_LOG(LogTemp, Warning, TEXT("Reachable cells count: %d (occupancy version %u)"),
+                        ReachableCells.CountSetBits(), GridManager->GetOccupancyVersion());
 
-                    if (ReachableCells.Contains(Cell))
+                    if (ReachableCells.Test(CellIndex))
                     {
-                        FString Origin = GetCellIdentifier(SelectedUnitForMovement->CurrentCell);
-                        UE_LOG(LogTemp, Warning, TEXT("Moving unit from %s to cell %s"), *Origin, *GetCellIdentifier(Cell));
-                        SelectedUnitForMovement->MoveToCell(Cell);
+                        FString Origin = GetCellIdentifier(SelectedUnitForMovement->CurrentCellIndex);
+                        UE_LOG(LogTemp, Warning, TEXT("Moving unit from %s to cell %s"), *Origin, *GetCellIdentifier(CellIndex));
+                        SelectedUnitForMovement->MoveToCell(CellIndex);
                         SelectedUnitForMovement->bHasMoved = true;
 
                         FString UnitPrefix;
@@ -231,13 +291,13 @@ void AMyGameMode::OnGridCellClicked(AGridCell* Cell)
                         else if (SelectedUnitForMovement->UnitType == EUnitType::Brawler)
                             UnitPrefix = "HP: B";
 
-                        HUD->SetExecutionText(UnitPrefix + " " + Origin, "->", GetCellIdentifier(Cell));
+                        HUD->SetExecutionText(UnitPrefix + " " + Origin, "->", GetCellIdentifier(CellIndex));
                         ResetAllCellHighlights();
                         // l'unit resta selezionata per permettere un eventuale attacco successivo
                     }
                     else
                     {
-                        UE_LOG(LogTemp, Warning, TEXT("Cell %s not reachable for movement"), *GetCellIdentifier(Cell));
+                        UE_LOG(LogTemp, Warning, TEXT("Cell %s not reachable for movement"), *GetCellIdentifier(CellIndex));
                     }
                 }
                 else
@@ -486,9 +546,9 @@ void AMyGameMode::AdvancePlacementTurn()
 }
 
 // Spawna e posiziona un'unit sulla cella specificata controllando se le condizioni di spawn sono valide
-void AMyGameMode::SpawnAndPlaceUnit(EUnitType UnitType, ETeamType TeamType, AGridCell* Cell)
+void AMyGameMode::SpawnAndPlaceUnit(EUnitType UnitType, ETeamType TeamType, int32 CellIndex)
 {
-    if (!Cell || !GridManager || Cell->bIsOccupied || Cell->bIsObstacle)
+    if (!GridManager || !GridManager->IsValidCell(CellIndex) || !GridManager->IsWalkable(CellIndex))
     {
         UE_LOG(LogTemp, Warning, TEXT("Invalid spawn conditions"));
         return;
@@ -496,7 +556,7 @@ void AMyGameMode::SpawnAndPlaceUnit(EUnitType UnitType, ETeamType TeamType, AGri
 
     FActorSpawnParameters SpawnParams;
     ABaseUnit* NewUnit = nullptr;
-    FTransform SpawnTransform = Cell->GetActorTransform();
+    FTransform SpawnTransform(GridManager->GetCellLocation(CellIndex));
 
     if (UnitType == EUnitType::Sniper)
     {
@@ -511,7 +571,7 @@ void AMyGameMode::SpawnAndPlaceUnit(EUnitType UnitType, ETeamType TeamType, AGri
     {
         NewUnit->Initialize(UnitType, TeamType);
         UGameplayStatics::FinishSpawningActor(NewUnit, SpawnTransform);
-        NewUnit->PlaceOnGrid(Cell);
+        NewUnit->PlaceOnGrid(CellIndex);
     }
 }
 
@@ -526,12 +586,12 @@ void AMyGameMode::PlaceAIUnit()
         return;
     }
 
-    TArray<AGridCell*> FreeCells;
-    for (AGridCell* Cell : GridManager->GridCells)
+    TArray<int32> FreeCells;
+    for (int32 Index = 0; Index < GridManager->GetNumCells(); Index++)
     {
-        if (Cell && !Cell->bIsOccupied && !Cell->bIsObstacle)
+        if (GridManager->IsWalkable(Index))
         {
-            FreeCells.Add(Cell);
+            FreeCells.Add(Index);
         }
     }
     UE_LOG(LogTemp, Warning, TEXT("Free cells found: %d"), FreeCells.Num());
@@ -539,8 +599,8 @@ void AMyGameMode::PlaceAIUnit()
     if (FreeCells.Num() > 0)
     {
         int32 RandomIndex = FMath::RandRange(0, FreeCells.Num() - 1);
-        AGridCell* SelectedCell = FreeCells[RandomIndex];
-        UE_LOG(LogTemp, Warning, TEXT("AI selects cell: %s"), *SelectedCell->GetName());
+        int32 SelectedCell = FreeCells[RandomIndex];
+        UE_LOG(LogTemp, Warning, TEXT("AI selects cell: %s"), *GetCellIdentifier(SelectedCell));
 
         if (CurrentPlacementTurn == EPlacementTurn::AISniper)
         {
@@ -567,13 +627,15 @@ void AMyGameMode::PlaceAIUnit()
     }
 }
 
-void AMyGameMode::CreateUnitPreview(EUnitType UnitType, ETeamType TeamType, AGridCell* Cell)
+void AMyGameMode::CreateUnitPreview(EUnitType UnitType, ETeamType TeamType, int32 CellIndex)
 {
-    if (!Cell)
+    if (!GridManager || !GridManager->IsValidCell(CellIndex))
     {
         return;
     }
 
+    FVector CellLocation = GridManager->GetCellLocation(CellIndex);
+
     // Elimina eventuale anteprima esistente
     DestroyUnitPreview();
 
@@ -583,11 +645,11 @@ void AMyGameMode::CreateUnitPreview(EUnitType UnitType, ETeamType TeamType, AGri
     // Spawna l'unit di anteprima in base al tipo
     if (UnitType == EUnitType::Sniper)
     {
-        PreviewUnit = GetWorld()->SpawnActor<ASniperUnit>(ASniperUnit::StaticClass(), Cell->GetActorLocation(), FRotator::ZeroRotator, SpawnParams);
+        PreviewUnit = GetWorld()->SpawnActor<ASniperUnit>(ASniperUnit::StaticClass(), CellLocation, FRotator::ZeroRotator, SpawnParams);
     }
     else if (UnitType == EUnitType::Brawler)
     {
-        PreviewUnit = GetWorld()->SpawnActor<ABrawlerUnit>(ABrawlerUnit::StaticClass(), Cell->GetActorLocation(), FRotator::ZeroRotator, SpawnParams);
+        PreviewUnit = GetWorld()->SpawnActor<ABrawlerUnit>(ABrawlerUnit::StaticClass(), CellLocation, FRotator::ZeroRotator, SpawnParams);
     }
 
     if (PreviewUnit)
@@ -612,7 +674,6 @@ void AMyGameMode::CreateUnitPreview(EUnitType UnitType, ETeamType TeamType, AGri
         }
 
         // Posiziona l'anteprima appena sopra la cella 
-        FVector CellLocation = Cell->GetActorLocation();
         PreviewUnit->SetActorLocation(FVector(CellLocation.X, CellLocation.Y, CellLocation.Z + 50.0f));
     }
 }
@@ -636,7 +697,7 @@ void AMyGameMode::StartUnitPlacement()
 // Visualizza i range di movimento e attacco per l'unit selezionata
 void AMyGameMode::DisplayUnitRanges(ABaseUnit* SelectedUnit)
 {
-    if (!SelectedUnit || SelectedUnit->TeamType != ETeamType::Player || !SelectedUnit->CurrentCell || !GridManager)
+    if (!SelectedUnit || SelectedUnit->TeamType != ETeamType::Player || SelectedUnit->CurrentCellIndex == INDEX_NONE || !GridManager)
     {
         return;
     }
@@ -648,99 +709,45 @@ void AMyGameMode::DisplayUnitRanges(ABaseUnit* SelectedUnit)
         return;
     }
 
-    ResetAllCellHighlights();
-
-    int32 OriginX = SelectedUnit->CurrentCell->GridX;
-    int32 OriginY = SelectedUnit->CurrentCell->GridY;
+    int32 Origin = SelectedUnit->CurrentCellIndex;
 
     // Calcola il range di movimento 
-    TSet<AGridCell*> ReachableCells;
-    if (!SelectedUnit->bHasMoved)
-    {
-        ReachableCells = GetReachableCells(SelectedUnit);
-    }
+    const FGridBitboard* ReachableCells = SelectedUnit->bHasMoved ? nullptr : &GetReachableCells(SelectedUnit);
 
-    // Calcola l'insieme delle celle nel range d'attacco basato sulla distanza Manhattan
-    TSet<AGridCell*> AttackCells;
-    for (AGridCell* Cell : GridManager->GridCells)
-    {
-        if (!Cell || Cell->bIsObstacle)
-            continue;
-        int32 DeltaX = FMath::Abs(Cell->GridX - OriginX);
-        int32 DeltaY = FMath::Abs(Cell->GridY - OriginY);
-        int32 ManhattanDistance = DeltaX + DeltaY;
-        if (ManhattanDistance <= SelectedUnit->AttackRange)
-        {
-            AttackCells.Add(Cell);
-        }
-    }
+    // Calcola le celle nel range d'attacco basato sulla distanza Manhattan (per il corpo a corpo solo le celle adiacenti)
+    const bool bRanged = SelectedUnit->AttackType.Equals(TEXT("Ranged Attack"));
+    const int32 AttackRadius = bRanged ? SelectedUnit->AttackRange : 1;
 
     // Definisce i colori per evidenziare il range di movimento e attacco
     FLinearColor MovementRangeColor(1.0f, 0.2f, 0.6f, 0.8f); // Rosa 
     FLinearColor AttackRangeColor(0.1f, 0.0f, 0.1f, 0.8f);    // Viola 
 
-    if (SelectedUnit->AttackType.Equals(TEXT("Ranged Attack")))
+    // Nuove evidenziazioni: il movimento ha la precedenza sull'attacco per le unit a distanza,
+    // mentre per il corpo a corpo le celle adiacenti mostrano sempre l'attacco
+    TMap<int32, FLinearColor> NewHighlights;
+    NewHighlights.Reserve((ReachableCells ? ReachableCells->CountSetBits() : 0) + 2 * AttackRadius * (AttackRadius + 1));
+    if (ReachableCells)
     {
-        if (!SelectedUnit->bHasMoved)
-        {
-            for (AGridCell* Cell : ReachableCells)
-            {
-                Cell->HighlightCell(MovementRangeColor);
-            }
-            for (AGridCell* Cell : AttackCells)
-            {
-                if (!ReachableCells.Contains(Cell))
-                {
-                    Cell->HighlightCell(AttackRangeColor);
-                }
-            }
-        }
-        else
+        ReachableCells->ForEachSetBit([&NewHighlights, &MovementRangeColor](int32 Index)
         {
-            // Se l'unit ha mosso, evidenzia solo il range d'attacco perch una volta mosso, l'unit potrebbe ancora attaccare
-            for (AGridCell* Cell : AttackCells)
-            {
-                Cell->HighlightCell(AttackRangeColor);
-            }
-        }
+            NewHighlights.Add(Index, MovementRangeColor);
+        });
     }
-    else
+    GridManager->ForEachCellInRange(Origin, AttackRadius, [&](int32 Index)
     {
-        if (!SelectedUnit->bHasMoved)
+        // Il rombo di raggio 1 del corpo a corpo include la cella dell'unit, che non va evidenziata
+        if (GridManager->IsObstacle(Index) || (!bRanged && Index == Origin))
         {
-            for (AGridCell* Cell : GridManager->GridCells)
-            {
-                if (!Cell || Cell->bIsObstacle)
-                    continue;
-                int32 DeltaX = FMath::Abs(Cell->GridX - OriginX);
-                int32 DeltaY = FMath::Abs(Cell->GridY - OriginY);
-                int32 ManhattanDistance = DeltaX + DeltaY;
-                if (ManhattanDistance == 1)
-                {
-                    Cell->HighlightCell(AttackRangeColor);
-                }
-                else if (ReachableCells.Contains(Cell))
-                {
-                    Cell->HighlightCell(MovementRangeColor);
-                }
-            }
+            return;
         }
-        else
+        if (!bRanged || !NewHighlights.Contains(Index))
         {
-            for (AGridCell* Cell : GridManager->GridCells)
-            {
-                if (!Cell || Cell->bIsObstacle)
-                    continue;
-                int32 DeltaX = FMath::Abs(Cell->GridX - OriginX);
-                int32 DeltaY = FMath::Abs(Cell->GridY - OriginY);
-                int32 ManhattanDistance = DeltaX + DeltaY;
-                if (ManhattanDistance == 1)
-                {
-                    Cell->HighlightCell(AttackRangeColor);
-                }
-            }
+            NewHighlights.Add(Index, AttackRangeColor);
         }
-    }
+    });
+
+    // Aggiorna solo le celle il cui colore cambia rispetto alla selezione precedente
+    ApplyCellHighlights(NewHighlights);
 
     // Mantiene l'unit selezionata per consentire l'attacco
     SelectedUnitForMovement = SelectedUnit;
@@ -748,77 +755,75 @@ void AMyGameMode::DisplayUnitRanges(ABaseUnit* SelectedUnit)
 }
 
 // Resetta l'evidenziazione di tutte le celle della griglia
+// Rimuove le evidenziazioni: vengono toccate solo le celle attualmente evidenziate
 void AMyGameMode::ResetAllCellHighlights()
+{
+    ApplyCellHighlights(TMap<int32, FLinearColor>());
+}
+
+// Confronta le evidenziazioni richieste con quelle attuali e aggiorna solo le celle cambiate:
+// il costo  proporzionale al range mostrato, non alla dimensione della griglia
+void AMyGameMode::ApplyCellHighlights(const TMap<int32, FLinearColor>& NewHighlights)
 {
     if (!GridManager)
     {
         return;
     }
-    for (AGridCell* Cell : GridManager->GridCells)
+
+    for (const TPair<int32, FLinearColor>& Highlight : HighlightedCells)
     {
-        if (Cell)
+        if (!NewHighlights.Contains(Highlight.Key))
         {
-            Cell->ResetHighlight();
+            GridManager->ResetCellHighlight(Highlight.Key);
         }
     }
-}
 
-// Calcola le celle raggiungibili da un'unit usando la BFS
-TSet<AGridCell*> AMyGameMode::GetReachableCells(ABaseUnit* Unit)
-{
-    TSet<AGridCell*> Reachable;
-    if (!Unit || !Unit->CurrentCell || !GridManager) return Reachable;
+    for (const TPair<int32, FLinearColor>& Highlight : NewHighlights)
+    {
+        const FLinearColor* CurrentColor = HighlightedCells.Find(Highlight.Key);
+        if (!CurrentColor || !CurrentColor->Equals(Highlight.Value))
+        {
+            GridManager->HighlightCell(Highlight.Key, Highlight.Value);
+        }
+    }
 
-    const int32 MaxRange = Unit->MovementRange;
-    TQueue<TPair<AGridCell*, int32>> Queue;
-    TSet<AGridCell*> Visited;
+    HighlightedCells = NewHighlights;
+}
 
-    Queue.Enqueue(TPair<AGridCell*, int32>(Unit->CurrentCell, 0));
-    Visited.Add(Unit->CurrentCell);
+// Calcola le celle raggiungibili da un'unit come maschera di bit. Il risultato viene dalla cache del GridManager,
+// che rif la ricerca solo se l'occupazione della griglia  cambiata dall'ultima richiesta.
+// Per un'unit non valida l'area  vuota
+const FGridBitboard& AMyGameMode::GetReachableCells(ABaseUnit* Unit)
+{
+    return GridManager->GetReachableArea(Unit ? Unit->CurrentCellIndex : INDEX_NONE, Unit ? Unit->MovementRange : 0).Cells;
+}
 
-    while (!Queue.IsEmpty())
+bool AMyGameMode::BuildTacticsState(FTacticsState& OutState, TArray<ABaseUnit*>& OutUnits) const
+{
+    OutUnits.Reset();
+    if (!GridManager || !OutState.Init(GridManager->GridRows, GridManager->GridColumns, GridManager->GetObstacleData()))
     {
-        TPair<AGridCell*, int32> CurrentPair;
-        Queue.Dequeue(CurrentPair);
-        AGridCell* CurrentCell = CurrentPair.Key;
-        int32 Distance = CurrentPair.Value;
+        return false;
+    }
 
-        if (Distance > 0)
+    TArray<AActor*> FoundUnits;
+    UGameplayStatics::GetAllActorsOfClass(GetWorld(), ABaseUnit::StaticClass(), FoundUnits);
+    for (AActor* Actor : FoundUnits)
+    {
+        ABaseUnit* Unit = Cast<ABaseUnit>(Actor);
+        if (!Unit || Unit->Health <= 0 || !GridManager->IsValidCell(Unit->CurrentCellIndex))
         {
-            Reachable.Add(CurrentCell);
+            continue;
         }
-
-        if (Distance < MaxRange)
+        if (OutState.AddUnit(FTacticsUnit::FromUnit(Unit)) == INDEX_NONE)
         {
-            TArray<AGridCell*> Neighbors;
-            for (AGridCell* Cell : GridManager->GridCells)
-            {
-                if (Cell)
-                {
-                    if ((Cell->GridX == CurrentCell->GridX + 1 && Cell->GridY == CurrentCell->GridY) ||
-                        (Cell->GridX == CurrentCell->GridX - 1 && Cell->GridY == CurrentCell->GridY) ||
-                        (Cell->GridX == CurrentCell->GridX && Cell->GridY == CurrentCell->GridY + 1) ||
-                        (Cell->GridX == CurrentCell->GridX && Cell->GridY == CurrentCell->GridY - 1))
-                    {
-                        Neighbors.Add(Cell);
-                    }
-                }
-            }
-
-            for (AGridCell* Neighbor : Neighbors)
-            {
-                if (!Visited.Contains(Neighbor))
-                {
-                    if (!Neighbor->bIsObstacle && (!Neighbor->bIsOccupied || Neighbor == Unit->CurrentCell))
-                    {
-                        Visited.Add(Neighbor);
-                        Queue.Enqueue(TPair<AGridCell*, int32>(Neighbor, Distance + 1));
-                    }
-                }
-            }
+            return false;
         }
+        OutUnits.Add(Unit);
     }
-    return Reachable;
+
+    OutState.SetSideToMove((CurrentMovementTurn == EMovementTurn::AI) ? ETeamType::AI : ETeamType::Player);
+    return true;
 }
 
 // Gestisce le azioni dell'IA durante il turno di movimento/azione
@@ -827,13 +832,62 @@ void AMyGameMode::MoveAIUnits()
     ResetAIUnitsMovement();
     if (bGameOver) { return; }
 
+    // I risultati delle ricerche del turno del giocatore non servono pi
+    GridManager->ResetTurnSearchResults();
+
     ProcessPendingCounterattacks();
 
+    // L'IA a ricerca pensa in background e gioca il turno quando il piano  pronto;
+    // se la griglia o le unit non entrano nello stato si usa l'euristica
+    AITurnStartTime = FPlatformTime::Seconds();
+    if (AIEngine != EAIEngine::Heuristic && StartAIPlanning(GetAIThinkingTimeMs()))
+    {
+        return;
+    }
+
     TArray<AActor*> PlayerUnits;
     UGameplayStatics::GetAllActorsOfClass(GetWorld(), ABaseUnit::StaticClass(), PlayerUnits);
     TArray<AActor*> FoundUnits;
     UGameplayStatics::GetAllActorsOfClass(GetWorld(), ABaseUnit::StaticClass(), FoundUnits);
 
+    // Bersagli del movimento: le unit del giocatore ancora in vita. Senza tabella delle distanze ognuno ha un
+    // campo di distanze (una BFS per bersaglio, letta da tutte le unit IA invece di due ricerche per unit)
+    TArray<ABaseUnit*> MoveTargets;
+    for (AActor* PActor : PlayerUnits)
+    {
+        ABaseUnit* PlayerUnit = Cast<ABaseUnit>(PActor);
+        if (PlayerUnit && PlayerUnit->TeamType == ETeamType::Player && PlayerUnit->Health > 0 && GridManager->IsValidCell(PlayerUnit->CurrentCellIndex))
+        {
+            MoveTargets.Add(PlayerUnit);
+        }
+    }
+
+    // Con la tabella delle distanze precalcolata non serve nessuna BFS: distanze e passi si leggono direttamente
+    // Sulle griglie grandi ogni unit IA cerca invece un percorso sul grafo gerarchico verso ciascun bersaglio
+    const FGridDistanceTable* DistanceTable = GridManager->GetDistanceTable();
+    FGridHierarchy* Hierarchy = DistanceTable ? nullptr : GridManager->GetHierarchy();
+    PlayerFlowFields.SetNum((DistanceTable || Hierarchy) ? 0 : MoveTargets.Num());
+    TArray<int32> Route;
+    TArray<int32> BestRoute;
+    for (int32 i = 0; i < PlayerFlowFields.Num(); i++)
+    {
+        PlayerFlowFields[i].Build(GridManager->GridRows, GridManager->GridColumns, GridManager->GetObstacleData(), MoveTargets[i]->CurrentCellIndex, GridManager->GetSearchContext());
+    }
+
+    // Distanza a piedi e passo successivo verso il bersaglio i-esimo (INDEX_NONE se non raggiungibile)
+    auto GetWalkDistance = [&](int32 TargetIndex, int32 Cell)
+    {
+        return DistanceTable
+            ? DistanceTable->GetDistance(Cell, MoveTargets[TargetIndex]->CurrentCellIndex)
+            : PlayerFlowFields[TargetIndex].GetDistance(Cell);
+    };
+    auto GetNextStep = [&](int32 TargetIndex, int32 Cell)
+    {
+        return DistanceTable
+            ? DistanceTable->GetNextStep(Cell, MoveTargets[TargetIndex]->CurrentCellIndex)
+            : PlayerFlowFields[TargetIndex].GetNextCell(Cell);
+    };
+
     for (AActor* Actor : FoundUnits)
     {
         ABaseUnit* AIUnit = Cast<ABaseUnit>(Actor);
@@ -849,9 +903,7 @@ void AMyGameMode::MoveAIUnits()
                 ABaseUnit* PlayerUnit = Cast<ABaseUnit>(PActor);
                 if (PlayerUnit && PlayerUnit->TeamType == ETeamType::Player && PlayerUnit->Health > 0)
                 {
-                    int32 DeltaX = FMath::Abs(AIUnit->CurrentCell->GridX - PlayerUnit->CurrentCell->GridX);
-                    int32 DeltaY = FMath::Abs(AIUnit->CurrentCell->GridY - PlayerUnit->CurrentCell->GridY);
-                    int32 ManhattanDistance = DeltaX + DeltaY;
+                    int32 ManhattanDistance = GridManager->GetDistance(AIUnit->CurrentCellIndex, PlayerUnit->CurrentCellIndex);
 
                     bool bInRange = (AIUnit->AttackType.Equals(TEXT("Ranged Attack")))
                         ? (ManhattanDistance <= AIUnit->AttackRange)
@@ -859,7 +911,7 @@ void AMyGameMode::MoveAIUnits()
 
                     if (bInRange)
                     {
-                        FString TargetCellID = GetCellIdentifier(PlayerUnit->CurrentCell);
+                        FString TargetCellID = GetCellIdentifier(PlayerUnit->CurrentCellIndex);
                         AIUnit->AttackTarget(PlayerUnit);
                         AIUnit->bHasAttacked = true;
                         int32 Damage = 4;
@@ -884,102 +936,113 @@ void AMyGameMode::MoveAIUnits()
 
             if (bHasActed) continue;  // se ha gi attaccato passa alla prossima unit IA
 
-            // Movimento verso il giocatore pi vicino
-            TSet<AGridCell*> ReachableCells = GetReachableCells(AIUnit);
-            TArray<AGridCell*> ReachableArray = ReachableCells.Array();
-
-            if (ReachableArray.Num() > 0)
+            // Movimento verso il giocatore pi vicino a piedi, seguendo la tabella delle distanze, il percorso gerarchico o il campo del bersaglio
+            int32 TargetIndex = INDEX_NONE;
+            int32 MinDistance = TNumericLimits<int32>::Max();
+            for (int32 i = 0; i < MoveTargets.Num(); i++)
             {
-                ABaseUnit* NearestPlayer = nullptr;
-                int32 MinDistance = TNumericLimits<int32>::Max();
-
-                // Trova il giocatore pi vicino
-                for (AActor* PActor : PlayerUnits)
+                if (!IsValid(MoveTargets[i]) || MoveTargets[i]->Health <= 0)
                 {
-                    ABaseUnit* PlayerUnit = Cast<ABaseUnit>(PActor);
-                    if (PlayerUnit && PlayerUnit->TeamType == ETeamType::Player && PlayerUnit->Health > 0)
+                    continue;
+                }
+                int32 Distance = INDEX_NONE;
+                if (Hierarchy)
+                {
+                    if (Hierarchy->FindPath(GridManager->GetObstacleData(), GridManager->GetOccupiedData(), AIUnit->CurrentCellIndex,
+                        MoveTargets[i]->CurrentCellIndex, GridManager->GetSearchContext(), Route))
                     {
-                        int32 Distance = FMath::Abs(AIUnit->CurrentCell->GridX - PlayerUnit->CurrentCell->GridX) +
-                            FMath::Abs(AIUnit->CurrentCell->GridY - PlayerUnit->CurrentCell->GridY);
-                        if (Distance < MinDistance)
-                        {
-                            MinDistance = Distance;
-                            NearestPlayer = PlayerUnit;
-                        }
+                        Distance = Route.Num() - 1;
                     }
                 }
+                else
+                {
+                    Distance = GetWalkDistance(i, AIUnit->CurrentCellIndex);
+                }
+                if (Distance != INDEX_NONE && Distance < MinDistance)
+                {
+                    MinDistance = Distance;
+                    TargetIndex = i;
+                    Swap(Route, BestRoute);
+                }
+            }
 
-                AGridCell* TargetCell = nullptr;
-                int32 BestDistance = TNumericLimits<int32>::Max();
-
-                // Seleziona cella migliore verso il giocatore
-                if (NearestPlayer)
+            // Avanza fino al raggio di movimento, fermandosi prima del bersaglio o di una cella occupata
+            TArray<int32> MovePath;
+            if (TargetIndex != INDEX_NONE)
+            {
+                const int32 TargetCellIndex = MoveTargets[TargetIndex]->CurrentCellIndex;
+                MovePath.Add(AIUnit->CurrentCellIndex);
+                if (Hierarchy)
                 {
-                    for (AGridCell* Cell : ReachableArray)
+                    // Il percorso completo  gi noto: se ne percorre solo l'inizio
+                    for (int32 Step = 1; Step < BestRoute.Num() && MovePath.Num() <= AIUnit->MovementRange; Step++)
                     {
-                        int32 DistanceToTarget = FMath::Abs(Cell->GridX - NearestPlayer->CurrentCell->GridX) +
-                            FMath::Abs(Cell->GridY - NearestPlayer->CurrentCell->GridY);
-                        if (DistanceToTarget < BestDistance)
+                        if (BestRoute[Step] == TargetCellIndex || !GridManager->IsWalkable(BestRoute[Step]))
                         {
-                            BestDistance = DistanceToTarget;
-                            TargetCell = Cell;
+                            break;
                         }
+                        MovePath.Add(BestRoute[Step]);
                     }
                 }
-
-                if (TargetCell)
+                else
                 {
-                    FString Origin = GetCellIdentifier(AIUnit->CurrentCell);
-                    AIUnit->MoveToCell(TargetCell);
-                    AIUnit->bHasMoved = true;
+                    int32 NextCell = GetNextStep(TargetIndex, AIUnit->CurrentCellIndex);
+                    while (MovePath.Num() <= AIUnit->MovementRange && NextCell != TargetCellIndex && GridManager->IsWalkable(NextCell))
+                    {
+                        MovePath.Add(NextCell);
+                        NextCell = GetNextStep(TargetIndex, NextCell);
+                    }
+                }
+            }
 
-                    // Aggiorna subito la cella corrente
-                    AIUnit->CurrentCell = TargetCell;
+            if (MovePath.Num() > 1)
+            {
+                const int32 TargetCell = MovePath.Last();
+                FString Origin = GetCellIdentifier(AIUnit->CurrentCellIndex);
+                AIUnit->MoveAlongPath(MovePath);
+                AIUnit->bHasMoved = true;
 
-                    FString AIUnitPrefix = (AIUnit->UnitType == EUnitType::Sniper) ? "AI: S" : "AI: B";
+                FString AIUnitPrefix = (AIUnit->UnitType == EUnitType::Sniper) ? "AI: S" : "AI: B";
 
-                    if (HUD)
-                    {
-                        HUD->SetExecutionText(AIUnitPrefix + " " + Origin, "->", GetCellIdentifier(TargetCell));
-                    }
+                if (HUD)
+                {
+                    HUD->SetExecutionText(AIUnitPrefix + " " + Origin, "->", GetCellIdentifier(TargetCell));
+                }
 
-                    UE_LOG(LogTemp, Warning, TEXT("%s moved from cell %s to %s"),
-                        *ABaseUnit::GetUnitDescription(AIUnit),
-                        *Origin, *GetCellIdentifier(TargetCell));
+                UE_LOG(LogTemp, Warning, TEXT("%s moved from cell %s to %s"),
+                    *ABaseUnit::GetUnitDescription(AIUnit),
+                    *Origin, *GetCellIdentifier(TargetCell));
 
-                    // Dopo il movimento verifica di nuovo se pu attaccare
-                    for (AActor* PActor : PlayerUnits)
+                // Dopo il movimento verifica di nuovo se pu attaccare
+                for (AActor* PActor : PlayerUnits)
+                {
+                    ABaseUnit* PlayerUnit = Cast<ABaseUnit>(PActor);
+                    if (PlayerUnit && PlayerUnit->TeamType == ETeamType::Player && PlayerUnit->Health > 0)
                     {
-                        ABaseUnit* PlayerUnit = Cast<ABaseUnit>(PActor);
-                        if (PlayerUnit && PlayerUnit->TeamType == ETeamType::Player && PlayerUnit->Health > 0)
-                        {
-                            int32 DeltaX = FMath::Abs(AIUnit->CurrentCell->GridX - PlayerUnit->CurrentCell->GridX);
-                            int32 DeltaY = FMath::Abs(AIUnit->CurrentCell->GridY - PlayerUnit->CurrentCell->GridY);
-                            int32 ManhattanDistance = DeltaX + DeltaY;
+                        int32 ManhattanDistance = GridManager->GetDistance(AIUnit->CurrentCellIndex, PlayerUnit->CurrentCellIndex);
+
+                        bool bInRange = (AIUnit->AttackType.Equals(TEXT("Ranged Attack")))
+                            ? (ManhattanDistance <= AIUnit->AttackRange)
+                            : (ManhattanDistance == 1);
 
-                            bool bInRange = (AIUnit->AttackType.Equals(TEXT("Ranged Attack")))
-                                ? (ManhattanDistance <= AIUnit->AttackRange)
-                                : (ManhattanDistance == 1);
+                        if (bInRange)
+                        {
+                            FString TargetCellID = GetCellIdentifier(PlayerUnit->CurrentCellIndex);
+                            AIUnit->AttackTarget(PlayerUnit);
+                            AIUnit->bHasAttacked = true;
+                            int32 Damage = 4;
 
-                            if (bInRange)
+                            if (HUD)
                             {
-                                FString TargetCellID = GetCellIdentifier(PlayerUnit->CurrentCell);
-                                AIUnit->AttackTarget(PlayerUnit);
-                                AIUnit->bHasAttacked = true;
-                                int32 Damage = 4;
-
-                                if (HUD)
-                                {
-                                    HUD->SetExecutionText(AIUnitPrefix, TargetCellID, FString::FromInt(Damage));
-                                }
-                                UE_LOG(LogTemp, Warning, TEXT("%s attacks %s at cell %s causing %d damage AFTER MOVING"),
-                                    *ABaseUnit::GetUnitDescription(AIUnit),
-                                    *ABaseUnit::GetUnitDescription(PlayerUnit),
-                                    *TargetCellID, Damage);
-
-                                CheckWinCondition();
-                                break;
+                                HUD->SetExecutionText(AIUnitPrefix, TargetCellID, FString::FromInt(Damage));
                             }
+                            UE_LOG(LogTemp, Warning, TEXT("%s attacks %s at cell %s causing %d damage AFTER MOVING"),
+                                *ABaseUnit::GetUnitDescription(AIUnit),
+                                *ABaseUnit::GetUnitDescription(PlayerUnit),
+                                *TargetCellID, Damage);
+
+                            CheckWinCondition();
+                            break;
                         }
                     }
                 }
@@ -994,13 +1057,213 @@ void AMyGameMode::MoveAIUnits()
         }
     }
 
+    FinishAITurn();
+}
+
+void AMyGameMode::FinishAITurn()
+{
     if (!bGameOver)
     {
+        GridManager->ResetTurnSearchResults();
         CurrentMovementTurn = EMovementTurn::Player;
         UpdateMovementMessage(TEXT("Player Turn: It's your turn to move or attack"));
     }
 }
 
+bool AMyGameMode::StartAIPlanning(double BudgetMs)
+{
+    FTacticsState State;
+    TArray<ABaseUnit*> Units;
+    if (!BuildTacticsState(State, Units))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("AI planning: the grid or the units do not fit the tactics state, using the heuristic AI"));
+        return false;
+    }
+
+    FTacticsPlannerSettings Settings;
+    Settings.TimeBudgetMs = BudgetMs;
+    Settings.bUseMonteCarlo = (AIEngine == EAIEngine::MonteCarlo);
+    Settings.Search.MaxDepth = AISearchMaxDepth;
+    Settings.Search.NumThreads = AISearchThreads;
+    Settings.Mcts.NumWorkers = AIMctsWorkers > 0 ? AIMctsWorkers : FMath::Max(FTaskGraphInterface::Get().GetNumWorkerThreads() - 1, 1);
+    Settings.Mcts.Seed = FMath::Rand();
+    if (AITranspositionTableMB > 0)
+    {
+        if (!SearchTable.IsValid())
+        {
+            SearchTable = MakeShared<FTacticsTranspositionTable>();
+            SearchTable->Init(AITranspositionTableMB);
+        }
+        Settings.TranspositionTable = SearchTable;
+    }
+
+    // Mentre l'IA pensa il giocatore non pu selezionare, muovere o attaccare
+    SelectedUnitForMovement = nullptr;
+    ResetAllCellHighlights();
+    bAITurn = true;
+
+    AIPlanUnits.Reset(Units.Num());
+    for (ABaseUnit* Unit : Units)
+    {
+        AIPlanUnits.Add(Unit);
+    }
+
+    AIPlanner.Start(State, Settings);
+    SetActorTickEnabled(true);
+    UpdateMovementMessage(TEXT("AI Turn: thinking..."));
+    return true;
+}
+
+void AMyGameMode::PlayAIPlan(const FTacticsPlan& Plan)
+{
+    // Gli input tornano al giocatore a fine piano; una nuova pianificazione li blocca di nuovo
+    bAITurn = false;
+    if (Plan.bCancelled || bGameOver)
+    {
+        return;
+    }
+
+    if (AIEngine == EAIEngine::MonteCarlo)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("MCTS AI plan: %d actions, %lld playouts in %.2f ms (%.0f playouts/s per thread)"),
+            Plan.Actions.Num(), Plan.Work, Plan.ElapsedMs, Plan.ElapsedMs > 0.0 ? Plan.Work / (Plan.ElapsedMs / 1000.0) / Plan.NumWorkers : 0.0);
+    }
+    else
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Search AI plan: %d actions, %lld nodes in %.2f ms (%.2f million nodes/s), table hit rate %.1f%%"),
+            Plan.Actions.Num(), Plan.Work, Plan.ElapsedMs, Plan.ElapsedMs > 0.0 ? Plan.Work / Plan.ElapsedMs / 1000.0 : 0.0,
+            Plan.TableProbes > 0 ? 100.0 * Plan.TableHits / Plan.TableProbes : 0.0);
+    }
+
+    // Un'unit eliminata sparisce dallo stato ricostruito e le unit dopo di lei cambiano indice:
+    // gli indici del piano vanno riportati agli attori e poi agli indici attuali
+    TArray<ABaseUnit*> Units;
+    auto RemapUnit = [this, &Units](int32 PlanIndex) -> int32
+    {
+        ABaseUnit* Unit = AIPlanUnits.IsValidIndex(PlanIndex) ? AIPlanUnits[PlanIndex].Get() : nullptr;
+        return Unit ? Units.IndexOfByKey(Unit) : INDEX_NONE;
+    };
+
+    FTacticsState State;
+    for (const FTacticsAction& PlannedAction : Plan.Actions)
+    {
+        if (bGameOver || !BuildTacticsState(State, Units))
+        {
+            break;
+        }
+
+        FTacticsAction Action = PlannedAction;
+        bool bLegal = true;
+        switch (PlannedAction.GetType())
+        {
+        case ETacticsActionType::Move:
+        {
+            const int32 Unit = RemapUnit(PlannedAction.GetUnit());
+            bLegal = (Unit != INDEX_NONE);
+            Action = FTacticsAction::Move(FMath::Max(Unit, 0), PlannedAction.GetCell());
+            break;
+        }
+        case ETacticsActionType::Attack:
+        {
+            const int32 Unit = RemapUnit(PlannedAction.GetUnit());
+            const int32 Target = RemapUnit(PlannedAction.GetTarget());
+            bLegal = (Unit != INDEX_NONE && Target != INDEX_NONE);
+            Action = FTacticsAction::Attack(FMath::Max(Unit, 0), FMath::Max(Target, 0));
+            break;
+        }
+        case ETacticsActionType::Pass:
+        {
+            const int32 Unit = RemapUnit(PlannedAction.GetUnit());
+            bLegal = (Unit != INDEX_NONE);
+            Action = FTacticsAction::Pass(FMath::Max(Unit, 0));
+            break;
+        }
+        default:
+            break;
+        }
+
+        // Il piano  stato fatto con i danni medi: se un tiro diverso ha reso illegale l'azione
+        // (per esempio il bersaglio  gi stato eliminato) si ripianifica dalla posizione vera
+        if (bLegal)
+        {
+            FTacticsActionList Legal;
+            State.GenerateActions(Legal);
+            bLegal = false;
+            for (int32 i = 0; i < Legal.Num && !bLegal; i++)
+            {
+                bLegal = (Legal.Actions[i] == Action);
+            }
+        }
+        if (!bLegal)
+        {
+            const double RemainingMs = GetAIThinkingTimeMs() - (FPlatformTime::Seconds() - AITurnStartTime) * 1000.0;
+            if (FTacticsSearch::CountRemainingActions(State) > 0 && StartAIPlanning(FMath::Max(RemainingMs, 50.0)))
+            {
+                return;
+            }
+            break;
+        }
+
+        ExecuteAIAction(Action, Units);
+    }
+
+    FinishAITurn();
+}
+
+void AMyGameMode::ExecuteAIAction(FTacticsAction Action, const TArray<ABaseUnit*>& Units)
+{
+    ABaseUnit* AIUnit = Units[Action.GetUnit()];
+    FString AIUnitPrefix = (AIUnit->UnitType == EUnitType::Sniper) ? "AI: S" : "AI: B";
+
+    switch (Action.GetType())
+    {
+    case ETacticsActionType::Move:
+    {
+        // La destinazione  tra le celle raggiungibili: il percorso si legge dalla visita in cache
+        const int32 TargetCell = Action.GetCell();
+        FString Origin = GetCellIdentifier(AIUnit->CurrentCellIndex);
+        GridManager->GetReachableArea(AIUnit->CurrentCellIndex, AIUnit->MovementRange);
+        AIUnit->MoveToCell(TargetCell);
+        AIUnit->bHasMoved = true;
+
+        if (HUD)
+        {
+            HUD->SetExecutionText(AIUnitPrefix + " " + Origin, "->", GetCellIdentifier(TargetCell));
+        }
+        UE_LOG(LogTemp, Warning, TEXT("%s moved from cell %s to %s"),
+            *ABaseUnit::GetUnitDescription(AIUnit),
+            *Origin, *GetCellIdentifier(TargetCell));
+        break;
+    }
+
+    case ETacticsActionType::Attack:
+    {
+        ABaseUnit* PlayerUnit = Units[Action.GetTarget()];
+        FString TargetCellID = GetCellIdentifier(PlayerUnit->CurrentCellIndex);
+        const int32 HealthBefore = PlayerUnit->Health;
+        AIUnit->AttackTarget(PlayerUnit);
+        AIUnit->bHasAttacked = true;
+        const int32 Damage = HealthBefore - PlayerUnit->Health;
+
+        if (HUD)
+        {
+            HUD->SetExecutionText(AIUnitPrefix, TargetCellID, FString::FromInt(Damage));
+        }
+        UE_LOG(LogTemp, Warning, TEXT("%s attacks %s at cell %s causing %d damage"),
+            *ABaseUnit::GetUnitDescription(AIUnit),
+            *ABaseUnit::GetUnitDescription(PlayerUnit),
+            *TargetCellID, Damage);
+
+        CheckWinCondition();
+        break;
+    }
+
+    default:
+        AIUnit->PerformDummyMove();
+        break;
+    }
+}
+
 // Verifica la condizione di vittoria controllando se entrambe le unit di una squadra sono state eliminate
 void AMyGameMode::CheckWinCondition()
 {
@@ -1101,6 +1364,7 @@ void AMyGameMode::EndPlayerTurn()
     }
     ResetPlayerUnitsMovement();
     ResetAllCellHighlights();
+    SelectedUnitForMovement = nullptr;
 
     CheckWinCondition();
     if (bGameOver)
@@ -1116,14 +1380,14 @@ void AMyGameMode::EndPlayerTurn()
 }
 
 // Rappresentazione delle celle tramite lettera-numero
-FString AMyGameMode::GetCellIdentifier(AGridCell* Cell)
+FString AMyGameMode::GetCellIdentifier(int32 CellIndex)
 {
-    if (!Cell)
+    if (!GridManager || !GridManager->IsValidCell(CellIndex))
     {
         return FString("Unknown");
     }
 
-    char Letter = 'A' + Cell->GridX;
-    int Number = Cell->GridY + 1;
+    char Letter = 'A' + GridManager->GetCellX(CellIndex);
+    int Number = GridManager->GetCellY(CellIndex) + 1;
     return FString::Printf(TEXT("%c%d"), Letter, Number);
 }
@@ -1,6 +1,8 @@
 #include "MyPlayerController.h"
 #include "MyGameMode.h"
 #include "GridCell.h"
+#include "GridManager.h"
+#include "BaseUnit.h"
 #include "Kismet/GameplayStatics.h"
 #include "GameFramework/PlayerController.h"
 
@@ -50,7 +52,26 @@ void AMyPlayerController::BeginPlay()
     SetInputMode(InputMode);
 
     // Inizializza la variabile per l'hover delle celle della griglia
-    LastHoveredCell = nullptr;
+    LastHoveredCellIndex = INDEX_NONE;
+}
+
+int32 AMyPlayerController::GetCellIndexUnderCursor(AGridManager* GridManager) const
+{
+    if (!GridManager)
+    {
+        return INDEX_NONE;
+    }
+
+    // Con la griglia instanziata le celle non sono attori: la cella si ricava dal piano della griglia sotto il cursore
+    if (GridManager->IsInstanced())
+    {
+        FVector RayOrigin, RayDirection;
+        return DeprojectMousePositionToWorld(RayOrigin, RayDirection) ? GridManager->GetCellIndexFromRay(RayOrigin, RayDirection) : INDEX_NONE;
+    }
+
+    FHitResult Hit;
+    AGridCell* Cell = GetHitResultUnderCursor(ECC_Visibility, true, Hit) ? Cast<AGridCell>(Hit.GetActor()) : nullptr;
+    return Cell ? Cell->CellIndex : INDEX_NONE;
 }
 
 void AMyPlayerController::SetupInputComponent()
@@ -73,19 +94,80 @@ void AMyPlayerController::ProcessPlayerInput(const float DeltaTime, const bool b
         }
     }
 
+    // Spostamento della telecamera: con la vista dall'alto l'alto dello schermo corrisponde all'asse X
+    if (MyTopDownCameraActor)
+    {
+        FVector PanDirection = FVector::ZeroVector;
+        if (IsInputKeyDown(EKeys::W) || IsInputKeyDown(EKeys::Up))
+        {
+            PanDirection.X += 1.f;
+        }
+        if (IsInputKeyDown(EKeys::S) || IsInputKeyDown(EKeys::Down))
+        {
+            PanDirection.X -= 1.f;
+        }
+        if (IsInputKeyDown(EKeys::D) || IsInputKeyDown(EKeys::Right))
+        {
+            PanDirection.Y += 1.f;
+        }
+        if (IsInputKeyDown(EKeys::A) || IsInputKeyDown(EKeys::Left))
+        {
+            PanDirection.Y -= 1.f;
+        }
+        if (!PanDirection.IsZero())
+        {
+            MyTopDownCameraActor->AddActorWorldOffset(PanDirection.GetSafeNormal() * CameraPanSpeed * DeltaTime);
+        }
+    }
+
     AMyGameMode* GM = Cast<AMyGameMode>(UGameplayStatics::GetGameMode(GetWorld()));
 
+    // Hover: il box informativo segue la cella sotto il cursore, in entrambe le modalit della griglia
+    if (AGridManager* HoverGridManager = GM ? GM->GridManager : nullptr)
+    {
+        const int32 HoveredCellIndex = GetCellIndexUnderCursor(HoverGridManager);
+        if (HoveredCellIndex != LastHoveredCellIndex)
+        {
+            if (LastHoveredCellIndex != INDEX_NONE)
+            {
+                HoverGridManager->SetCellHovered(LastHoveredCellIndex, false);
+            }
+            if (HoveredCellIndex != INDEX_NONE)
+            {
+                HoverGridManager->SetCellHovered(HoveredCellIndex, true);
+            }
+            LastHoveredCellIndex = HoveredCellIndex;
+        }
+    }
+
     // Gestione del click del mouse
     if (WasInputKeyJustPressed(EKeys::LeftMouseButton))
     {
         FHitResult Hit;
-        if (GetHitResultUnderCursor(ECC_Visibility, true, Hit) && Hit.GetActor())
+        const bool bHit = GetHitResultUnderCursor(ECC_Visibility, true, Hit) && Hit.GetActor();
+
+        AGridManager* GridManager = GM ? GM->GridManager : nullptr;
+        if (GridManager && GridManager->IsInstanced())
+        {
+            // Con la griglia instanziata le celle non sono attori: se il click non  su un'unit
+            // (gestito dall'unit stessa), la cella viene ricavata dal piano della griglia sotto il cursore
+            FVector RayOrigin, RayDirection;
+            if (!(bHit && Cast<ABaseUnit>(Hit.GetActor())) && DeprojectMousePositionToWorld(RayOrigin, RayDirection))
+            {
+                const int32 CellIndex = GridManager->GetCellIndexFromRay(RayOrigin, RayDirection);
+                if (CellIndex != INDEX_NONE)
+                {
+                    GM->OnGridCellClicked(CellIndex);
+                }
+            }
+        }
+        else if (bHit)
         {
             AGridCell* Cell = Cast<AGridCell>(Hit.GetActor());
             if (Cell && GM)
             {
                 // Inoltra l'evento di click al GameMode
-                GM->OnGridCellClicked(Cell);
+                GM->OnGridCellClicked(Cell->CellIndex);
             }
         }
     }
@@ -0,0 +1,402 @@
+#include "TacticsMcts.h"
+#include "TacticsSearch.h"
+#include "BaseUnit.h"
+#include "Async/ParallelFor.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+
+DECLARE_FLOAT_COUNTER_STAT(TEXT("MCTS playouts/s per thread"), STAT_PaaMctsPlayoutsPerThread, STATGROUP_PaaAI);
+DECLARE_DWORD_COUNTER_STAT(TEXT("MCTS workers"), STAT_PaaMctsWorkers, STATGROUP_PaaAI);
+
+namespace
+{
+    // Comando da console per lanciare il benchmark: Paa.BenchmarkTacticsMcts [BudgetMs]
+    FAutoConsoleCommand TacticsMctsBenchmarkCommand(
+        TEXT("Paa.BenchmarkTacticsMcts"),
+        TEXT("Runs root-parallel MCTS on random 25x25 positions with 1, 2, 4... workers and logs playouts per second per thread. Usage: Paa.BenchmarkTacticsMcts [BudgetMs]"),
+        FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+        {
+            const double BudgetMs = Args.Num() > 0 ? FMath::Max(FCString::Atod(*Args[0]), 1.0) : 200.0;
+            FTacticsMcts::RunBenchmark(25, BudgetMs, 12345);
+        }));
+
+    // Arco dell'albero: statistiche dell'azione dal punto di vista di chi la esegue
+    struct FMctsEdge
+    {
+        FTacticsAction Action;
+        int32 Child = INDEX_NONE;
+        int32 Visits = 0;
+        float TotalValue = 0.f;
+    };
+
+    // Nodo dell'albero: i suoi archi sono contigui in Edges
+    struct FMctsNode
+    {
+        int32 FirstEdge = 0;
+        int32 NumEdges = 0;
+        int32 Visits = 0;
+    };
+
+    // L'albero  open loop: un'azione salvata alla prima visita pu non essere pi legale in una discesa
+    // con tiri diversi. Un'unit eliminata libera la sua cella, quindi un movimento creato in quella discesa
+    // va ricontrollato sulle celle raggiungibili adesso
+    bool IsStillLegal(const FTacticsState& State, FTacticsAction Action)
+    {
+        const FTacticsUnit& Unit = State.Units[Action.GetUnit()];
+        switch (Action.GetType())
+        {
+        case ETacticsActionType::Move:
+        {
+            if (!Unit.IsAlive() || Unit.Flags != 0)
+            {
+                return false;
+            }
+            uint64 Reachable[FTacticsState::MaxRows];
+            State.GetReachableRows(Action.GetUnit(), Reachable);
+            const int32 Cell = Action.GetCell();
+            return (Reachable[Cell / State.Columns] >> (Cell % State.Columns)) & 1;
+        }
+
+        case ETacticsActionType::Pass:
+            return Unit.IsAlive() && Unit.Flags == 0;
+
+        case ETacticsActionType::Attack:
+            return Unit.IsAlive() && !Unit.HasAttacked() && State.Units[Action.GetTarget()].IsAlive()
+                && State.IsInAttackRange(Action.GetUnit(), Action.GetTarget());
+
+        default:
+            for (int32 Index = 0; Index < State.NumUnits; Index++)
+            {
+                if (State.Units[Index].Team == State.SideToMove && State.Units[Index].IsAlive() && State.Units[Index].Flags == 0)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+    }
+
+    // Estrae l'esito dei tiri di un attacco
+    FTacticsAction RollOutcome(const FTacticsState& State, FTacticsAction Action, FRandomStream& Stream)
+    {
+        if (Action.GetType() != ETacticsActionType::Attack)
+        {
+            return Action;
+        }
+        const FTacticsUnit& Attacker = State.Units[Action.GetUnit()];
+        const int32 Damage = Stream.RandRange(Attacker.MinDamage, FMath::Max(Attacker.MaxDamage, Attacker.MinDamage));
+        const int32 Counter = State.HasCounterattack(Action.GetUnit(), Action.GetTarget()) ? Stream.RandRange(1, FTacticsState::MaxCounterDamage) : 0;
+        return Action.WithOutcome(Damage, Counter);
+    }
+
+    // Albero di un worker: tutta la memoria  sua, quindi i worker non si sincronizzano mai
+    class FMctsTree
+    {
+    public:
+
+        FMctsTree(const FTacticsState& InRoot, const FTacticsMctsSettings& InSettings, int32 Seed)
+            : Root(InRoot), Settings(InSettings), Stream(Seed)
+        {
+            Nodes.Reserve(4096);
+            Edges.Reserve(FMath::Min(Settings.MaxEdgesPerWorker, 1 << 16));
+            FMctsNode RootNode;
+            Expand(Root, RootNode);
+            Nodes.Add(RootNode);
+        }
+
+        // Esegue simulazioni fino alla scadenza e restituisce quante ne ha completate
+        int64 Run(double Deadline)
+        {
+            int64 Playouts = 0;
+            while (FPlatformTime::Seconds() < Deadline && !(Settings.CancelFlag && Settings.CancelFlag->load(std::memory_order_relaxed)))
+            {
+                RunPlayout();
+                Playouts++;
+            }
+            return Playouts;
+        }
+
+        // Archi della radice, nello stesso ordine in tutti gli alberi
+        const FMctsEdge* GetRootEdges() const { return Edges.GetData(); }
+        int32 GetNumRootEdges() const { return Nodes[0].NumEdges; }
+
+    private:
+
+        // Crea gli archi del nodo con le azioni legali, nell'ordine della ricerca: UCT prova per prime le azioni
+        // non ancora visitate, quindi l'ordine decide quali vengono esplorate quando il tempo  poco
+        bool Expand(const FTacticsState& State, FMctsNode& OutNode)
+        {
+            FTacticsActionList Actions;
+            State.GenerateActions(Actions);
+            if (Actions.Num == 0 || Edges.Num() + Actions.Num > Settings.MaxEdgesPerWorker)
+            {
+                return false;
+            }
+
+            int32 Scores[FTacticsActionList::MaxActions];
+            for (int32 i = 0; i < Actions.Num; i++)
+            {
+                Scores[i] = FTacticsSearch::GetOrderingScore(State, Actions.Actions[i]);
+            }
+            for (int32 i = 1; i < Actions.Num; i++)
+            {
+                for (int32 j = i; j > 0 && Scores[j] > Scores[j - 1]; j--)
+                {
+                    Swap(Scores[j], Scores[j - 1]);
+                    Swap(Actions.Actions[j], Actions.Actions[j - 1]);
+                }
+            }
+
+            OutNode.FirstEdge = Edges.Num();
+            OutNode.NumEdges = Actions.Num;
+            for (int32 i = 0; i < Actions.Num; i++)
+            {
+                FMctsEdge Edge;
+                Edge.Action = Actions.Actions[i];
+                Edges.Add(Edge);
+            }
+            return true;
+        }
+
+        // Arco con il valore UCT pi alto tra quelli ancora legali (INDEX_NONE se nessuno lo )
+        int32 SelectEdge(int32 NodeIndex, const FTacticsState& State) const
+        {
+            const FMctsNode& Node = Nodes[NodeIndex];
+            const float LogVisits = FMath::Loge((float)FMath::Max(Node.Visits, 1));
+            int32 BestEdge = INDEX_NONE;
+            float BestScore = -MAX_flt;
+            for (int32 EdgeIndex = Node.FirstEdge; EdgeIndex < Node.FirstEdge + Node.NumEdges; EdgeIndex++)
+            {
+                const FMctsEdge& Edge = Edges[EdgeIndex];
+                if (!IsStillLegal(State, Edge.Action))
+                {
+                    continue;
+                }
+                if (Edge.Visits == 0)
+                {
+                    return EdgeIndex;
+                }
+                const float Score = Edge.TotalValue / Edge.Visits + Settings.Exploration * FMath::Sqrt(LogVisits / Edge.Visits);
+                if (Score > BestScore)
+                {
+                    BestScore = Score;
+                    BestEdge = EdgeIndex;
+                }
+            }
+            return BestEdge;
+        }
+
+        // Azione della simulazione: casuale, oppure la migliore per l'ordinamento tra tre estratte a caso
+        FTacticsAction PickRolloutAction(const FTacticsState& State, const FTacticsActionList& Actions)
+        {
+            FTacticsAction Best = Actions.Actions[Stream.RandRange(0, Actions.Num - 1)];
+            if (Settings.bHeuristicRollouts)
+            {
+                int32 BestScore = FTacticsSearch::GetOrderingScore(State, Best);
+                for (int32 Sample = 0; Sample < 2; Sample++)
+                {
+                    const FTacticsAction Candidate = Actions.Actions[Stream.RandRange(0, Actions.Num - 1)];
+                    const int32 Score = FTacticsSearch::GetOrderingScore(State, Candidate);
+                    if (Score > BestScore)
+                    {
+                        BestScore = Score;
+                        Best = Candidate;
+                    }
+                }
+            }
+            return Best;
+        }
+
+        // Gioca la partita fino alla fine o fino a MaxRolloutActions; risultato tra 0 e 1 per la squadra della radice
+        float Rollout(FTacticsState& State)
+        {
+            FTacticsActionList Actions;
+            for (int32 Step = 0; Step < Settings.MaxRolloutActions && !State.IsGameOver(); Step++)
+            {
+                Actions.Num = 0;
+                State.GenerateActions(Actions);
+                State.Apply(RollOutcome(State, PickRolloutAction(State, Actions), Stream));
+            }
+
+            if (State.IsGameOver())
+            {
+                return State.HasLivingUnits(Root.SideToMove) ? 1.f : 0.f;
+            }
+            // Partita non finita: la valutazione statica diventa una probabilit di vittoria
+            return 1.f / (1.f + FMath::Exp(-FTacticsSearch::Evaluate(State, Root.SideToMove) / 50.f));
+        }
+
+        // Selezione, espansione di un nodo, simulazione e aggiornamento degli archi percorsi
+        void RunPlayout()
+        {
+            FTacticsState State = Root;
+            // Archi percorsi, con il segno del risultato per chi ha eseguito l'azione
+            TArray<TPair<int32, bool>, TInlineAllocator<64>> Path;
+
+            int32 NodeIndex = 0;
+            while (!State.IsGameOver())
+            {
+                const int32 EdgeIndex = SelectEdge(NodeIndex, State);
+                if (EdgeIndex == INDEX_NONE)
+                {
+                    break;
+                }
+
+                Path.Add(TPair<int32, bool>(EdgeIndex, State.SideToMove == Root.SideToMove));
+                State.Apply(RollOutcome(State, Edges[EdgeIndex].Action, Stream));
+
+                // Arco nuovo: il nodo figlio viene creato ora e la discesa si ferma qui
+                if (Edges[EdgeIndex].Child == INDEX_NONE)
+                {
+                    FMctsNode Child;
+                    if (State.IsGameOver() || Expand(State, Child))
+                    {
+                        Edges[EdgeIndex].Child = Nodes.Add(Child);
+                    }
+                    break;
+                }
+                NodeIndex = Edges[EdgeIndex].Child;
+            }
+
+            const float Value = Rollout(State);
+
+            Nodes[0].Visits++;
+            for (const TPair<int32, bool>& Step : Path)
+            {
+                FMctsEdge& Edge = Edges[Step.Key];
+                Edge.Visits++;
+                Edge.TotalValue += Step.Value ? Value : 1.f - Value;
+                if (Edge.Child != INDEX_NONE)
+                {
+                    Nodes[Edge.Child].Visits++;
+                }
+            }
+        }
+
+        const FTacticsState Root;
+        const FTacticsMctsSettings& Settings;
+        FRandomStream Stream;
+        TArray<FMctsNode> Nodes;
+        TArray<FMctsEdge> Edges;
+    };
+}
+
+int32 FTacticsMcts::GetDefaultNumWorkers()
+{
+    return FMath::Max(FTaskGraphInterface::Get().GetNumWorkerThreads() + (IsInGameThread() ? 1 : 0), 1);
+}
+
+FTacticsAction FTacticsMcts::FindBestAction(const FTacticsState& State, const FTacticsMctsSettings& Settings, FTacticsMctsStats& OutStats)
+{
+    const double StartTime = FPlatformTime::Seconds();
+    OutStats = FTacticsMctsStats();
+
+    FTacticsActionList Actions;
+    State.GenerateActions(Actions);
+    if (Actions.Num <= 1)
+    {
+        return Actions.Num == 1 ? Actions.Actions[0] : FTacticsAction::EndTurn();
+    }
+
+    const int32 NumWorkers = Settings.NumWorkers > 0 ? Settings.NumWorkers : GetDefaultNumWorkers();
+    const double Deadline = StartTime + Settings.TimeBudgetMs / 1000.0;
+
+    // Un albero per worker, ognuno con il proprio seed: nessuna memoria condivisa durante la ricerca
+    TArray<TUniquePtr<FMctsTree>> Trees;
+    TArray<int64> Playouts;
+    Trees.SetNum(NumWorkers);
+    Playouts.SetNumZeroed(NumWorkers);
+    ParallelFor(NumWorkers, [&](int32 Worker)
+    {
+        Trees[Worker] = MakeUnique<FMctsTree>(State, Settings, Settings.Seed * 7919 + Worker * 104729 + 1);
+        Playouts[Worker] = Trees[Worker]->Run(Deadline);
+    }, Settings.bBackgroundPriority ? EParallelForFlags::BackgroundPriority : EParallelForFlags::None);
+
+    // Le radici hanno gli stessi archi nello stesso ordine: le visite si sommano per posizione
+    const int32 NumRootEdges = Trees[0]->GetNumRootEdges();
+    int32 BestEdge = 0;
+    int32 BestVisits = -1;
+    float BestTotalValue = 0.f;
+    for (int32 EdgeIndex = 0; EdgeIndex < NumRootEdges; EdgeIndex++)
+    {
+        int32 Visits = 0;
+        float TotalValue = 0.f;
+        for (const TUniquePtr<FMctsTree>& Tree : Trees)
+        {
+            Visits += Tree->GetRootEdges()[EdgeIndex].Visits;
+            TotalValue += Tree->GetRootEdges()[EdgeIndex].TotalValue;
+        }
+        if (Visits > BestVisits)
+        {
+            BestVisits = Visits;
+            BestTotalValue = TotalValue;
+            BestEdge = EdgeIndex;
+        }
+    }
+
+    // Un albero partito quando gli altri thread avevano gi consumato il tempo non ha simulazioni
+    // e non entra nella media per thread
+    for (int64 WorkerPlayouts : Playouts)
+    {
+        OutStats.Playouts += WorkerPlayouts;
+        OutStats.NumWorkers += WorkerPlayouts > 0 ? 1 : 0;
+    }
+    OutStats.NumWorkers = FMath::Max(OutStats.NumWorkers, 1);
+    OutStats.ElapsedMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+    OutStats.BestVisits = BestVisits;
+    OutStats.BestValue = BestVisits > 0 ? BestTotalValue / BestVisits : 0.f;
+
+    SET_FLOAT_STAT(STAT_PaaMctsPlayoutsPerThread, (float)OutStats.GetPlayoutsPerSecondPerThread());
+    SET_DWORD_STAT(STAT_PaaMctsWorkers, OutStats.NumWorkers);
+    return Trees[0]->GetRootEdges()[BestEdge].Action;
+}
+
+// Stesse posizioni con un numero crescente di worker: se la parallelizzazione scala,
+// le simulazioni al secondo per thread restano costanti
+void FTacticsMcts::RunBenchmark(int32 GridSize, double TimeBudgetMs, int32 Seed)
+{
+    const int32 MaxWorkers = GetDefaultNumWorkers();
+    UE_LOG(LogTemp, Warning, TEXT("Tactics MCTS benchmark, %dx%d grid, %.0f ms per action, up to %d workers"), GridSize, GridSize, TimeBudgetMs, MaxWorkers);
+
+    for (int32 NumWorkers = 1; ; NumWorkers = FMath::Min(NumWorkers * 2, MaxWorkers))
+    {
+        FRandomStream Stream(Seed);
+        FTacticsMctsSettings Settings;
+        Settings.TimeBudgetMs = TimeBudgetMs;
+        Settings.NumWorkers = NumWorkers;
+        Settings.Seed = Seed;
+
+        int64 Playouts = 0;
+        double ElapsedMs = 0.0;
+        double ThreadMs = 0.0;
+        for (int32 Position = 0; Position < 4; Position++)
+        {
+            FTacticsState State;
+            if (!State.InitRandom(GridSize, Stream))
+            {
+                UE_LOG(LogTemp, Warning, TEXT("Tactics MCTS benchmark: a %dx%d grid is larger than the supported %dx%d"),
+                    GridSize, GridSize, FTacticsState::MaxRows, FTacticsState::MaxColumns);
+                return;
+            }
+            State.SetSideToMove(ETeamType::AI);
+
+            FTacticsMctsStats Stats;
+            FindBestAction(State, Settings, Stats);
+            Playouts += Stats.Playouts;
+            ElapsedMs += Stats.ElapsedMs;
+            ThreadMs += Stats.ElapsedMs * Stats.NumWorkers;
+        }
+
+        // Per thread conta solo gli alberi che hanno fatto simulazioni
+        const double PerThread = ThreadMs > 0.0 ? Playouts / (ThreadMs / 1000.0) : 0.0;
+        UE_LOG(LogTemp, Warning, TEXT("%d workers: %lld playouts in %.2f ms (%.0f playouts/s, %.0f per thread)"),
+            NumWorkers, Playouts, ElapsedMs, ElapsedMs > 0.0 ? Playouts / (ElapsedMs / 1000.0) : 0.0, PerThread);
+
+        if (NumWorkers == MaxWorkers)
+        {
+            break;
+        }
+    }
+}
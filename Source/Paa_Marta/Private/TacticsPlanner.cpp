@@ -0,0 +1,114 @@
+#include "TacticsPlanner.h"
+#include "HAL/PlatformTime.h"
+
+FTacticsPlanner::~FTacticsPlanner()
+{
+    Cancel();
+}
+
+void FTacticsPlanner::Start(const FTacticsState& Snapshot, const FTacticsPlannerSettings& Settings)
+{
+    Cancel();
+
+    TSharedPtr<FJob> NewJob = MakeShared<FJob>();
+    NewJob->Snapshot = Snapshot;
+    NewJob->Settings = Settings;
+    Job = NewJob;
+
+    // Il task lavora solo sui dati del job, che tiene vivi finch non ha finito. Gira con priorit di background,
+    // come i thread delle ricerche, cos i worker in primo piano restano al motore e al rendering
+    NewJob->Settings.Search.bBackgroundPriority = true;
+    NewJob->Settings.Mcts.bBackgroundPriority = true;
+    Task = UE::Tasks::Launch(UE_SOURCE_LOCATION, [NewJob]()
+    {
+        NewJob->Plan = PlanTurn(NewJob->Snapshot, NewJob->Settings, &NewJob->bCancel);
+    }, UE::Tasks::ETaskPriority::BackgroundNormal);
+}
+
+bool FTacticsPlanner::TakePlan(FTacticsPlan& OutPlan)
+{
+    if (!Job.IsValid() || !Task.IsCompleted())
+    {
+        return false;
+    }
+    OutPlan = MoveTemp(Job->Plan);
+    Job.Reset();
+    return true;
+}
+
+void FTacticsPlanner::Cancel()
+{
+    if (Job.IsValid())
+    {
+        Job->bCancel = true;
+        Task.Wait();
+        Job.Reset();
+    }
+}
+
+FTacticsPlan FTacticsPlanner::PlanTurn(const FTacticsState& Snapshot, const FTacticsPlannerSettings& Settings, const std::atomic<bool>* CancelFlag)
+{
+    const double StartTime = FPlatformTime::Seconds();
+    FTacticsPlan Plan;
+    FTacticsState State = Snapshot;
+    const ETeamType Side = State.SideToMove;
+
+    FTacticsSearch Search;
+    FTacticsSearchSettings SearchSettings = Settings.Search;
+    SearchSettings.TranspositionTable = Settings.TranspositionTable.Get();
+    SearchSettings.CancelFlag = CancelFlag;
+    FTacticsMctsSettings MctsSettings = Settings.Mcts;
+    MctsSettings.CancelFlag = CancelFlag;
+
+    // Ogni azione imposta un flag di un'unit, quindi il piano ha al massimo due azioni per unit
+    while (State.SideToMove == Side && !State.IsGameOver())
+    {
+        if (CancelFlag && CancelFlag->load(std::memory_order_relaxed))
+        {
+            Plan.bCancelled = true;
+            break;
+        }
+
+        const double RemainingMs = Settings.TimeBudgetMs - (FPlatformTime::Seconds() - StartTime) * 1000.0;
+        const double ActionBudgetMs = FMath::Max(RemainingMs, 1.0) / FMath::Max(FTacticsSearch::CountRemainingActions(State), 1);
+
+        FTacticsAction Action;
+        if (Settings.bUseMonteCarlo)
+        {
+            MctsSettings.TimeBudgetMs = ActionBudgetMs;
+            MctsSettings.Seed += Plan.Actions.Num() + 1;
+            FTacticsMctsStats Stats;
+            Action = FTacticsMcts::FindBestAction(State, MctsSettings, Stats);
+            Plan.Work += Stats.Playouts;
+            Plan.NumWorkers = FMath::Max(Plan.NumWorkers, Stats.NumWorkers);
+        }
+        else
+        {
+            SearchSettings.TimeBudgetMs = ActionBudgetMs;
+            FTacticsSearchStats Stats;
+            Action = Search.FindBestAction(State, SearchSettings, Stats);
+            Plan.Work += Stats.Nodes;
+            Plan.TableProbes += Stats.TableProbes;
+            Plan.TableHits += Stats.TableHits;
+        }
+
+        if (Action.GetType() == ETacticsActionType::EndTurn)
+        {
+            break;
+        }
+        Plan.Actions.Add(Action);
+
+        // Le azioni successive vengono scelte supponendo il danno medio; il game thread controlla che siano
+        // ancora legali dopo i tiri veri
+        if (Action.GetType() == ETacticsActionType::Attack)
+        {
+            const FTacticsUnit& Attacker = State.Units[Action.GetUnit()];
+            const int32 Counter = State.HasCounterattack(Action.GetUnit(), Action.GetTarget()) ? (1 + FTacticsState::MaxCounterDamage) / 2 : 0;
+            Action = Action.WithOutcome((Attacker.MinDamage + Attacker.MaxDamage) / 2, Counter);
+        }
+        State.Apply(Action);
+    }
+
+    Plan.ElapsedMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+    return Plan;
+}
@@ -0,0 +1,530 @@
+#include "TacticsSearch.h"
+#include "BaseUnit.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Tasks/Task.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Search table hit rate"), STAT_PaaSearchTableHitRate, STATGROUP_PaaAI);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Search million nodes/s"), STAT_PaaSearchNodesPerSecond, STATGROUP_PaaAI);
+
+namespace
+{
+    // Le vittorie valgono WinScore meno la distanza: oltre questa soglia un valore contiene una distanza
+    constexpr float WinThreshold = FTacticsSearch::WinScore - 1000.f;
+
+    // Comando da console per lanciare il benchmark: Paa.BenchmarkTacticsSearch [BudgetMs]
+    FAutoConsoleCommand TacticsSearchBenchmarkCommand(
+        TEXT("Paa.BenchmarkTacticsSearch"),
+        TEXT("Runs the alpha-beta/expectimax AI search on random 25x25 positions and logs depth and nodes per second. Usage: Paa.BenchmarkTacticsSearch [BudgetMs]"),
+        FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+        {
+            const double BudgetMs = Args.Num() > 0 ? FMath::Max(FCString::Atod(*Args[0]), 1.0) : 100.0;
+            FTacticsSearch::RunBenchmark(25, BudgetMs, 8, 12345);
+        }));
+
+    // Distanza dall'unit nemica viva pi vicina (MAX_int32 se non ce ne sono)
+    int32 GetNearestEnemyDistance(const FTacticsState& State, int32 Unit, int32 Cell)
+    {
+        int32 Nearest = MAX_int32;
+        for (int32 Other = 0; Other < State.NumUnits; Other++)
+        {
+            if (State.Units[Other].Team != State.Units[Unit].Team && State.Units[Other].IsAlive())
+            {
+                Nearest = FMath::Min(Nearest, State.GetDistance(Cell, State.Units[Other].Cell));
+            }
+        }
+        return Nearest;
+    }
+
+    // Valore di posizione di un'unit nella cella: lo Sniper vuole un nemico nel raggio d'attacco,
+    // il Brawler vuole stare il pi vicino possibile
+    int32 GetPositionScore(const FTacticsState& State, int32 Unit, int32 Cell)
+    {
+        const FTacticsUnit& Current = State.Units[Unit];
+        const int32 Distance = GetNearestEnemyDistance(State, Unit, Cell);
+        if (Distance == MAX_int32)
+        {
+            return 0;
+        }
+        const int32 Reach = Current.bRanged ? Current.AttackRange : 1;
+        return Distance <= Reach ? 10 : Reach - Distance;
+    }
+}
+
+bool FTacticsSearch::VisitNode()
+{
+    Nodes++;
+    if ((Nodes & 1023) == 0 && !bAborted)
+    {
+        bAborted = FPlatformTime::Seconds() >= Deadline || (StopFlag && StopFlag->load(std::memory_order_relaxed));
+    }
+    return !bAborted;
+}
+
+float FTacticsSearch::ToTableScore(float Score, int32 Ply) const
+{
+    if (Score >= WinThreshold)
+    {
+        Score += Ply;
+    }
+    else if (Score <= -WinThreshold)
+    {
+        Score -= Ply;
+    }
+    return State.SideToMove == RootSide ? Score : -Score;
+}
+
+float FTacticsSearch::FromTableScore(float Score, int32 Ply) const
+{
+    if (State.SideToMove != RootSide)
+    {
+        Score = -Score;
+    }
+    if (Score >= WinThreshold)
+    {
+        Score -= Ply;
+    }
+    else if (Score <= -WinThreshold)
+    {
+        Score += Ply;
+    }
+    return Score;
+}
+
+float FTacticsSearch::Evaluate(const FTacticsState& State, ETeamType Side)
+{
+    float Score = 0.f;
+    for (int32 Unit = 0; Unit < State.NumUnits; Unit++)
+    {
+        const FTacticsUnit& Current = State.Units[Unit];
+        if (!Current.IsAlive())
+        {
+            continue;
+        }
+
+        // La vita pesa in proporzione al massimo, cos le due unit contano allo stesso modo
+        const float Value = 50.f + 100.f * Current.Health / FMath::Max<int32>(Current.HealthMax, 1)
+            + GetPositionScore(State, Unit, Current.Cell);
+        Score += (Current.Team == Side) ? Value : -Value;
+    }
+    return Score;
+}
+
+int32 FTacticsSearch::CountRemainingActions(const FTacticsState& State)
+{
+    int32 Count = 0;
+    for (int32 Unit = 0; Unit < State.NumUnits; Unit++)
+    {
+        const FTacticsUnit& Current = State.Units[Unit];
+        if (Current.Team == State.SideToMove && Current.IsAlive())
+        {
+            Count += (Current.Flags == 0) ? 2 : (Current.HasAttacked() ? 0 : 1);
+        }
+    }
+    return Count;
+}
+
+int32 FTacticsSearch::GetOrderingScore(const FTacticsState& State, FTacticsAction Action)
+{
+    switch (Action.GetType())
+    {
+    case ETacticsActionType::Attack:
+    {
+        const FTacticsUnit& Attacker = State.Units[Action.GetUnit()];
+        const FTacticsUnit& Target = State.Units[Action.GetTarget()];
+        int32 Score = 10000 + 10 * (Attacker.MinDamage + Attacker.MaxDamage);
+        if (Attacker.MaxDamage >= Target.Health)
+        {
+            Score += 5000;
+        }
+        if (State.HasCounterattack(Action.GetUnit(), Action.GetTarget()))
+        {
+            Score -= 20;
+        }
+        return Score;
+    }
+
+    case ETacticsActionType::EndTurn:
+        return 5000;
+
+    case ETacticsActionType::Move:
+        return 1000 + GetPositionScore(State, Action.GetUnit(), Action.GetCell());
+
+    default:
+        return 1000 + GetPositionScore(State, Action.GetUnit(), State.Units[Action.GetUnit()].Cell) - 1;
+    }
+}
+
+float FTacticsSearch::SearchAction(FTacticsAction Action, int32 Depth, int32 Ply, float Alpha, float Beta)
+{
+    if (Action.GetType() != ETacticsActionType::Attack)
+    {
+        const FTacticsUndo UndoInfo = State.Apply(Action);
+        const float Value = SearchNode(Depth - 1, Ply + 1, Alpha, Beta);
+        State.Undo(Action, UndoInfo);
+        return Value;
+    }
+
+    // Nodo di probabilit: tiri uniformi. I danni che eliminano il bersaglio portano tutti alla stessa posizione,
+    // quindi vengono visitati una volta sola con il peso complessivo
+    const FTacticsUnit& Attacker = State.Units[Action.GetUnit()];
+    const int32 MinDamage = Attacker.MinDamage;
+    const int32 MaxDamage = FMath::Max<int32>(Attacker.MaxDamage, MinDamage);
+    const int32 LastDamage = FMath::Clamp<int32>(State.Units[Action.GetTarget()].Health, MinDamage, MaxDamage);
+    const bool bCounter = State.HasCounterattack(Action.GetUnit(), Action.GetTarget());
+    const int32 MinCounter = bCounter ? 1 : 0;
+    const int32 MaxCounter = bCounter ? FTacticsState::MaxCounterDamage : 0;
+    const float OutcomeWeight = 1.f / ((MaxDamage - MinDamage + 1) * (MaxCounter - MinCounter + 1));
+
+    // I figli di un nodo di probabilit servono esatti per la media: finestra completa
+    float Expected = 0.f;
+    for (int32 Damage = MinDamage; Damage <= LastDamage; Damage++)
+    {
+        const float Weight = OutcomeWeight * (Damage == LastDamage ? MaxDamage - LastDamage + 1 : 1);
+        for (int32 Counter = MinCounter; Counter <= MaxCounter; Counter++)
+        {
+            const FTacticsAction Outcome = Action.WithOutcome(Damage, Counter);
+            const FTacticsUndo UndoInfo = State.Apply(Outcome);
+            Expected += Weight * SearchNode(Depth - 1, Ply + 1, -MAX_flt, MAX_flt);
+            State.Undo(Outcome, UndoInfo);
+            if (bAborted)
+            {
+                return 0.f;
+            }
+        }
+    }
+    return Expected;
+}
+
+float FTacticsSearch::SearchNode(int32 Depth, int32 Ply, float Alpha, float Beta)
+{
+    if (!VisitNode())
+    {
+        return 0.f;
+    }
+
+    if (State.IsGameOver())
+    {
+        return State.HasLivingUnits(RootSide) ? WinScore - Ply : -WinScore + Ply;
+    }
+    if (Depth == 0)
+    {
+        return Evaluate(State, RootSide);
+    }
+
+    // Posizione gi vista: il valore basta se la ricerca era profonda almeno quanto questa,
+    // altrimenti la sua azione migliore viene provata per prima
+    const bool bMaximizing = State.SideToMove == RootSide;
+    bool bHasTableAction = false;
+    FTacticsAction TableAction;
+    if (Table)
+    {
+        TableProbes++;
+        FTacticsTableEntry Entry;
+        if (Table->Probe(State.Hash, Entry))
+        {
+            TableHits++;
+            bHasTableAction = true;
+            TableAction = Entry.BestAction;
+            if (Entry.Depth >= Depth)
+            {
+                // I limiti sono salvati dal punto di vista di chi muove: per l'avversario si scambiano
+                const float Score = FromTableScore(Entry.Score, Ply);
+                ETacticsBound Bound = Entry.Bound;
+                if (!bMaximizing && Bound != ETacticsBound::Exact)
+                {
+                    Bound = (Bound == ETacticsBound::Lower) ? ETacticsBound::Upper : ETacticsBound::Lower;
+                }
+                if (Bound == ETacticsBound::Exact)
+                {
+                    return Score;
+                }
+                if (Bound == ETacticsBound::Lower)
+                {
+                    Alpha = FMath::Max(Alpha, Score);
+                }
+                else
+                {
+                    Beta = FMath::Min(Beta, Score);
+                }
+                if (Alpha >= Beta)
+                {
+                    return Score;
+                }
+            }
+        }
+    }
+    const float AlphaStart = Alpha;
+    const float BetaStart = Beta;
+
+    FTacticsActionList Actions;
+    State.GenerateActions(Actions);
+    int32 Scores[FTacticsActionList::MaxActions];
+    for (int32 i = 0; i < Actions.Num; i++)
+    {
+        Scores[i] = (bHasTableAction && Actions.Actions[i] == TableAction) ? MAX_int32 : GetOrderingScore(State, Actions.Actions[i]);
+    }
+
+    float Best = bMaximizing ? -MAX_flt : MAX_flt;
+    FTacticsAction BestAction = Actions.Actions[0];
+    for (int32 i = 0; i < Actions.Num; i++)
+    {
+        // Ordinamento per selezione: con i tagli spesso servono solo le prime azioni
+        int32 BestIndex = i;
+        for (int32 j = i + 1; j < Actions.Num; j++)
+        {
+            if (Scores[j] > Scores[BestIndex])
+            {
+                BestIndex = j;
+            }
+        }
+        Swap(Scores[i], Scores[BestIndex]);
+        Swap(Actions.Actions[i], Actions.Actions[BestIndex]);
+
+        const float Value = SearchAction(Actions.Actions[i], Depth, Ply, Alpha, Beta);
+        if (bAborted)
+        {
+            return 0.f;
+        }
+
+        if (bMaximizing ? Value > Best : Value < Best)
+        {
+            Best = Value;
+            BestAction = Actions.Actions[i];
+        }
+        if (bMaximizing)
+        {
+            Alpha = FMath::Max(Alpha, Value);
+        }
+        else
+        {
+            Beta = FMath::Min(Beta, Value);
+        }
+        if (Alpha >= Beta)
+        {
+            break;
+        }
+    }
+
+    if (Table)
+    {
+        // Limite dal punto di vista della radice, poi girato insieme al valore se muove l'avversario
+        ETacticsBound Bound = ETacticsBound::Exact;
+        if (Best <= AlphaStart)
+        {
+            Bound = bMaximizing ? ETacticsBound::Upper : ETacticsBound::Lower;
+        }
+        else if (Best >= BetaStart)
+        {
+            Bound = bMaximizing ? ETacticsBound::Lower : ETacticsBound::Upper;
+        }
+        Table->Store(State.Hash, ToTableScore(Best, Ply), Depth, Bound, BestAction);
+    }
+    return Best;
+}
+
+FTacticsAction FTacticsSearch::FindBestAction(const FTacticsState& InState, const FTacticsSearchSettings& Settings, FTacticsSearchStats& OutStats)
+{
+    FTacticsTranspositionTable* SharedTable = (Settings.TranspositionTable && Settings.TranspositionTable->IsValid()) ? Settings.TranspositionTable : nullptr;
+    const int32 NumThreads = SharedTable ? FMath::Max(Settings.NumThreads, 1) : 1;
+    if (SharedTable)
+    {
+        SharedTable->NewSearch();
+    }
+
+    // Gli altri thread girano come task finch questo (che decide l'azione) non ha finito: se il pool  occupato
+    // e non partono, la ricerca resta comunque quella di un thread solo
+    std::atomic<bool> bStop(false);
+    TArray<FTacticsSearch> Helpers;
+    TArray<FTacticsSearchStats> HelperStats;
+    TArray<UE::Tasks::FTask> HelperTasks;
+    Helpers.SetNum(NumThreads - 1);
+    HelperStats.SetNum(NumThreads - 1);
+    const UE::Tasks::ETaskPriority HelperPriority = Settings.bBackgroundPriority ? UE::Tasks::ETaskPriority::BackgroundNormal : UE::Tasks::ETaskPriority::Normal;
+    for (int32 Helper = 0; Helper < Helpers.Num(); Helper++)
+    {
+        HelperTasks.Add(UE::Tasks::Launch(UE_SOURCE_LOCATION, [&InState, &Settings, &Helpers, &HelperStats, &bStop, Helper]()
+        {
+            Helpers[Helper].StopFlag = &bStop;
+            Helpers[Helper].RunIterativeDeepening(InState, Settings, Helper + 1, HelperStats[Helper]);
+        }, HelperPriority));
+    }
+
+    StopFlag = Settings.CancelFlag;
+    const FTacticsAction BestAction = RunIterativeDeepening(InState, Settings, 0, OutStats);
+    bStop = true;
+    UE::Tasks::Wait(HelperTasks);
+
+    for (const FTacticsSearchStats& Stats : HelperStats)
+    {
+        OutStats.Nodes += Stats.Nodes;
+        OutStats.TableProbes += Stats.TableProbes;
+        OutStats.TableHits += Stats.TableHits;
+    }
+
+    SET_FLOAT_STAT(STAT_PaaSearchTableHitRate, (float)OutStats.GetTableHitRate());
+    SET_FLOAT_STAT(STAT_PaaSearchNodesPerSecond, (float)(OutStats.GetNodesPerSecond() / 1000000.0));
+    return BestAction;
+}
+
+FTacticsAction FTacticsSearch::RunIterativeDeepening(const FTacticsState& InState, const FTacticsSearchSettings& Settings, int32 ThreadIndex, FTacticsSearchStats& OutStats)
+{
+    const double StartTime = FPlatformTime::Seconds();
+    State = InState;
+    RootSide = State.SideToMove;
+    Deadline = StartTime + Settings.TimeBudgetMs / 1000.0;
+    Nodes = 0;
+    bAborted = false;
+    Table = (Settings.TranspositionTable && Settings.TranspositionTable->IsValid()) ? Settings.TranspositionTable : nullptr;
+    TableProbes = 0;
+    TableHits = 0;
+    OutStats = FTacticsSearchStats();
+
+    FTacticsActionList Actions;
+    State.GenerateActions(Actions);
+    if (Actions.Num == 0)
+    {
+        return FTacticsAction::EndTurn();
+    }
+
+    // Thread diversi partono da un ordine diverso a parit di punteggio e da profondit alternate,
+    // cos non ripetono esattamente la stessa ricerca
+    if (ThreadIndex > 0)
+    {
+        const int32 Shift = (ThreadIndex * 7) % Actions.Num;
+        FTacticsActionList Rotated;
+        for (int32 i = 0; i < Actions.Num; i++)
+        {
+            Rotated.Add(Actions.Actions[(i + Shift) % Actions.Num]);
+        }
+        Actions = Rotated;
+    }
+    const int32 FirstDepth = 1 + (ThreadIndex & 1);
+
+    // Ordine delle azioni alla radice: punteggio euristico, poi il valore trovato dall'iterazione precedente
+    float RootValues[FTacticsActionList::MaxActions];
+    for (int32 i = 0; i < Actions.Num; i++)
+    {
+        RootValues[i] = (float)GetOrderingScore(State, Actions.Actions[i]);
+    }
+
+    FTacticsAction BestAction = Actions.Actions[0];
+    if (Actions.Num > 1)
+    {
+        for (int32 Depth = FirstDepth; Depth <= Settings.MaxDepth; Depth++)
+        {
+            // L'azione migliore dell'iterazione precedente ha il valore pi alto e viene provata per prima
+            for (int32 i = 1; i < Actions.Num; i++)
+            {
+                for (int32 j = i; j > 0 && RootValues[j] > RootValues[j - 1]; j--)
+                {
+                    Swap(RootValues[j], RootValues[j - 1]);
+                    Swap(Actions.Actions[j], Actions.Actions[j - 1]);
+                }
+            }
+            if (Depth == FirstDepth)
+            {
+                BestAction = Actions.Actions[0];
+            }
+
+            float Alpha = -MAX_flt;
+            int32 IterationBest = INDEX_NONE;
+            int32 Searched = 0;
+            for (int32 i = 0; i < Actions.Num; i++)
+            {
+                const float Value = SearchAction(Actions.Actions[i], Depth, 0, Alpha, MAX_flt);
+                if (bAborted)
+                {
+                    break;
+                }
+                RootValues[i] = Value;
+                Searched++;
+                if (Value > Alpha)
+                {
+                    Alpha = Value;
+                    IterationBest = i;
+                }
+            }
+
+            // Un'iterazione interrotta vale solo se ha completato almeno l'azione migliore precedente:
+            // le azioni trovate dopo che la superano sono migliori anche alla nuova profondit
+            if (IterationBest != INDEX_NONE)
+            {
+                BestAction = Actions.Actions[IterationBest];
+                OutStats.Score = Alpha;
+            }
+            if (bAborted)
+            {
+                break;
+            }
+            for (int32 i = Searched; i < Actions.Num; i++)
+            {
+                RootValues[i] = -MAX_flt;
+            }
+            OutStats.CompletedDepth = Depth;
+
+            // Risultato deciso, oppure la prossima iterazione (molto pi grande) non ha speranza di finire in tempo
+            const double Elapsed = FPlatformTime::Seconds() - StartTime;
+            if (FMath::Abs(OutStats.Score) >= WinScore - Settings.MaxDepth || Elapsed * 2.0 >= Settings.TimeBudgetMs / 1000.0)
+            {
+                break;
+            }
+        }
+    }
+
+    OutStats.Nodes = Nodes;
+    OutStats.TableProbes = TableProbes;
+    OutStats.TableHits = TableHits;
+    OutStats.ElapsedMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+    return BestAction;
+}
+
+// Prima azione della squadra IA nelle stesse posizioni casuali, senza tabella, con la tabella e con la tabella
+// condivisa da tutti i thread: profondit media, nodi al secondo e percentuale di posizioni trovate
+void FTacticsSearch::RunBenchmark(int32 GridSize, double TimeBudgetMs, int32 NumPositions, int32 Seed)
+{
+    FTacticsTranspositionTable Table;
+    Table.Init(64);
+    const int32 MaxThreads = FTaskGraphInterface::Get().GetNumWorkerThreads() + 1;
+
+    UE_LOG(LogTemp, Warning, TEXT("Tactics search benchmark, %dx%d grid, %.0f ms per action, seed %d"), GridSize, GridSize, TimeBudgetMs, Seed);
+    for (int32 Config = 0; Config < 3; Config++)
+    {
+        FRandomStream Stream(Seed);
+        FTacticsSearchSettings Settings;
+        Settings.TimeBudgetMs = TimeBudgetMs;
+        Settings.TranspositionTable = (Config > 0) ? &Table : nullptr;
+        Settings.NumThreads = (Config == 2) ? MaxThreads : 1;
+        Table.Clear();
+        FTacticsSearch Search;
+
+        FTacticsSearchStats Total;
+        int32 TotalDepth = 0;
+        for (int32 Position = 0; Position < NumPositions; Position++)
+        {
+            FTacticsState State;
+            if (!State.InitRandom(GridSize, Stream))
+            {
+                UE_LOG(LogTemp, Warning, TEXT("Tactics search benchmark: a %dx%d grid is larger than the supported %dx%d"),
+                    GridSize, GridSize, FTacticsState::MaxRows, FTacticsState::MaxColumns);
+                return;
+            }
+            State.SetSideToMove(ETeamType::AI);
+
+            FTacticsSearchStats Stats;
+            Search.FindBestAction(State, Settings, Stats);
+            Total.Nodes += Stats.Nodes;
+            Total.ElapsedMs += Stats.ElapsedMs;
+            Total.TableProbes += Stats.TableProbes;
+            Total.TableHits += Stats.TableHits;
+            TotalDepth += Stats.CompletedDepth;
+        }
+
+        UE_LOG(LogTemp, Warning, TEXT("%s, %d threads: average depth %.2f, %lld nodes in %.2f ms (%.2f million nodes/s), table hit rate %.1f%%"),
+            Config == 0 ? TEXT("No table") : TEXT("Transposition table"), Settings.NumThreads,
+            NumPositions > 0 ? (double)TotalDepth / NumPositions : 0.0, Total.Nodes, Total.ElapsedMs,
+            Total.GetNodesPerSecond() / 1000000.0, Total.GetTableHitRate() * 100.0);
+    }
+}
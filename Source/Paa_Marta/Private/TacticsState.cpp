@@ -0,0 +1,453 @@
+#include "TacticsState.h"
+#include "BaseUnit.h"
+#include "SniperUnit.h"
+#include "BrawlerUnit.h"
+#include "GridGenerator.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+
+namespace
+{
+    // Chiavi casuali per l'hash Zobrist, generate una volta all'avvio con SplitMix64 (sempre le stesse)
+    struct FTacticsZobristKeys
+    {
+        uint64 Cell[FTacticsState::MaxUnits][FTacticsState::MaxRows * FTacticsState::MaxColumns];
+        uint64 Health[FTacticsState::MaxUnits][FTacticsState::MaxHealthBucket + 1];
+        uint64 Flags[FTacticsState::MaxUnits][4];
+        uint64 Side;
+
+        FTacticsZobristKeys()
+        {
+            uint64 Seed = 0x5A0B1257C0FFEEull;
+            auto Next = [&Seed]()
+            {
+                uint64 Z = (Seed += 0x9E3779B97F4A7C15ull);
+                Z = (Z ^ (Z >> 30)) * 0xBF58476D1CE4E5B9ull;
+                Z = (Z ^ (Z >> 27)) * 0x94D049BB133111EBull;
+                return Z ^ (Z >> 31);
+            };
+            for (int32 Unit = 0; Unit < FTacticsState::MaxUnits; Unit++)
+            {
+                for (uint64& Key : Cell[Unit])
+                {
+                    Key = Next();
+                }
+                for (uint64& Key : Health[Unit])
+                {
+                    Key = Next();
+                }
+                for (uint64& Key : Flags[Unit])
+                {
+                    Key = Next();
+                }
+            }
+            Side = Next();
+        }
+    };
+
+    const FTacticsZobristKeys ZobristKeys;
+
+    // Le unit eliminate stanno tutte nel secchio 0, la vita oltre MaxHealthBucket nell'ultimo
+    FORCEINLINE uint64 GetHealthKey(int32 Unit, int32 Health)
+    {
+        return ZobristKeys.Health[Unit][FMath::Clamp(Health, 0, FTacticsState::MaxHealthBucket)];
+    }
+
+    // Comando da console per lanciare il benchmark: Paa.BenchmarkTacticsState [Depth]
+    FAutoConsoleCommand TacticsStateBenchmarkCommand(
+        TEXT("Paa.BenchmarkTacticsState"),
+        TEXT("Counts positions reachable in Depth actions with make/unmake on a generated 25x25 map. Usage: Paa.BenchmarkTacticsState [Depth]"),
+        FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+        {
+            const int32 Depth = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 5;
+            FTacticsState::RunBenchmark(25, Depth, 12345);
+        }));
+
+    // Visita completa fino a Depth azioni: ogni posizione viene creata con Apply e disfatta con Undo
+    int64 CountPositions(FTacticsState& State, int32 Depth)
+    {
+        if (Depth == 0)
+        {
+            return 1;
+        }
+
+        FTacticsActionList Actions;
+        State.GenerateActions(Actions);
+
+        int64 Count = 0;
+        for (int32 i = 0; i < Actions.Num; i++)
+        {
+            FTacticsAction Action = Actions.Actions[i];
+            if (Action.GetType() == ETacticsActionType::Attack)
+            {
+                const FTacticsUnit& Attacker = State.Units[Action.GetUnit()];
+                const int32 Counter = State.HasCounterattack(Action.GetUnit(), Action.GetTarget()) ? 2 : 0;
+                Action = Action.WithOutcome((Attacker.MinDamage + Attacker.MaxDamage) / 2, Counter);
+            }
+
+            const FTacticsUndo UndoInfo = State.Apply(Action);
+            Count += CountPositions(State, Depth - 1);
+            State.Undo(Action, UndoInfo);
+        }
+        return Count;
+    }
+}
+
+FTacticsUnit FTacticsUnit::FromUnit(const ABaseUnit* Unit)
+{
+    FTacticsUnit Result;
+    Result.Cell = Unit->CurrentCellIndex;
+    Result.Health = (int16)Unit->Health;
+    Result.HealthMax = (int16)Unit->HealthMax;
+    Result.MovementRange = (uint8)Unit->MovementRange;
+    Result.AttackRange = (uint8)Unit->AttackRange;
+    Result.MinDamage = (uint8)Unit->MinDamage;
+    Result.MaxDamage = (uint8)Unit->MaxDamage;
+    Result.Type = Unit->UnitType;
+    Result.Team = Unit->TeamType;
+    Result.bRanged = Unit->AttackType.Equals(TEXT("Ranged Attack"));
+    Result.Flags = (Unit->bHasMoved ? MovedFlag : 0) | (Unit->bHasAttacked ? AttackedFlag : 0);
+    return Result;
+}
+
+bool FTacticsState::Init(int32 InRows, int32 InColumns, const TArray<bool>& Obstacles)
+{
+    if (InRows <= 0 || InColumns <= 0 || InRows > MaxRows || InColumns > MaxColumns || Obstacles.Num() != InRows * InColumns)
+    {
+        return false;
+    }
+
+    Rows = InRows;
+    Columns = InColumns;
+    FMemory::Memzero(ObstacleRows, sizeof(ObstacleRows));
+    for (int32 Cell = 0; Cell < Obstacles.Num(); Cell++)
+    {
+        if (Obstacles[Cell])
+        {
+            ObstacleRows[Cell / Columns] |= uint64(1) << (Cell % Columns);
+        }
+    }
+
+    NumUnits = 0;
+    SideToMove = ETeamType::Player;
+    Hash = ComputeHash();
+    return true;
+}
+
+void FTacticsState::SetSideToMove(ETeamType Side)
+{
+    if (Side != SideToMove)
+    {
+        SideToMove = Side;
+        Hash ^= ZobristKeys.Side;
+    }
+}
+
+uint64 FTacticsState::ComputeHash() const
+{
+    uint64 Result = (SideToMove == ETeamType::AI) ? ZobristKeys.Side : 0;
+    for (int32 Index = 0; Index < NumUnits; Index++)
+    {
+        Result ^= ZobristKeys.Cell[Index][Units[Index].Cell] ^ GetHealthKey(Index, Units[Index].Health) ^ ZobristKeys.Flags[Index][Units[Index].Flags];
+    }
+    return Result;
+}
+
+int32 FTacticsState::AddUnit(const FTacticsUnit& Unit)
+{
+    if (NumUnits == MaxUnits)
+    {
+        return INDEX_NONE;
+    }
+    Units[NumUnits] = Unit;
+    Hash ^= ZobristKeys.Cell[NumUnits][Unit.Cell] ^ GetHealthKey(NumUnits, Unit.Health) ^ ZobristKeys.Flags[NumUnits][Unit.Flags];
+    return NumUnits++;
+}
+
+int32 FTacticsState::GetUnitAt(int32 Cell) const
+{
+    for (int32 Index = 0; Index < NumUnits; Index++)
+    {
+        if (Units[Index].Cell == Cell && Units[Index].IsAlive())
+        {
+            return Index;
+        }
+    }
+    return INDEX_NONE;
+}
+
+bool FTacticsState::HasLivingUnits(ETeamType Team) const
+{
+    for (int32 Index = 0; Index < NumUnits; Index++)
+    {
+        if (Units[Index].Team == Team && Units[Index].IsAlive())
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool FTacticsState::IsGameOver() const
+{
+    return !HasLivingUnits(ETeamType::Player) || !HasLivingUnits(ETeamType::AI);
+}
+
+bool FTacticsState::IsInAttackRange(int32 Attacker, int32 Target) const
+{
+    const int32 Distance = GetDistance(Units[Attacker].Cell, Units[Target].Cell);
+    return Units[Attacker].bRanged ? Distance <= Units[Attacker].AttackRange : Distance == 1;
+}
+
+bool FTacticsState::HasCounterattack(int32 Attacker, int32 Target) const
+{
+    if (Units[Attacker].Type != EUnitType::Sniper)
+    {
+        return false;
+    }
+    return Units[Target].Type == EUnitType::Sniper
+        || (Units[Target].Type == EUnitType::Brawler && GetDistance(Units[Attacker].Cell, Units[Target].Cell) == 1);
+}
+
+// Stessa visita a strati di FGridBitboard::FloodFill, su righe di una sola parola e buffer sullo stack
+void FTacticsState::GetReachableRows(int32 Unit, uint64 (&OutRows)[MaxRows]) const
+{
+    FMemory::Memzero(OutRows, sizeof(OutRows));
+
+    const uint64 ColumnMask = (Columns == 64) ? ~uint64(0) : (uint64(1) << Columns) - 1;
+    uint64 Passable[MaxRows];
+    for (int32 Y = 0; Y < Rows; Y++)
+    {
+        Passable[Y] = ~ObstacleRows[Y] & ColumnMask;
+    }
+    for (int32 Index = 0; Index < NumUnits; Index++)
+    {
+        if (Units[Index].IsAlive())
+        {
+            Passable[Units[Index].Cell / Columns] &= ~(uint64(1) << (Units[Index].Cell % Columns));
+        }
+    }
+
+    uint64 LayerA[MaxRows] = {};
+    uint64 LayerB[MaxRows] = {};
+    uint64* Frontier = LayerA;
+    uint64* Next = LayerB;
+
+    const int32 OriginX = Units[Unit].Cell % Columns;
+    const int32 OriginY = Units[Unit].Cell / Columns;
+    Frontier[OriginY] = uint64(1) << OriginX;
+
+    for (int32 Layer = 1; Layer <= Units[Unit].MovementRange; Layer++)
+    {
+        const int32 MinY = FMath::Max(OriginY - Layer, 0);
+        const int32 MaxY = FMath::Min(OriginY + Layer, Rows - 1);
+        uint64 AnyNew = 0;
+        for (int32 Y = MinY; Y <= MaxY; Y++)
+        {
+            uint64 Spread = (Frontier[Y] << 1) | (Frontier[Y] >> 1);
+            if (Y > 0)
+            {
+                Spread |= Frontier[Y - 1];
+            }
+            if (Y + 1 < Rows)
+            {
+                Spread |= Frontier[Y + 1];
+            }
+            Next[Y] = Spread & Passable[Y] & ~OutRows[Y];
+            OutRows[Y] |= Next[Y];
+            AnyNew |= Next[Y];
+        }
+        if (AnyNew == 0)
+        {
+            break;
+        }
+        Swap(Frontier, Next);
+    }
+}
+
+int32 FTacticsState::GenerateActions(FTacticsActionList& OutActions) const
+{
+    const int32 FirstAction = OutActions.Num;
+    if (IsGameOver())
+    {
+        return 0;
+    }
+
+    bool bAllActed = true;
+    for (int32 Unit = 0; Unit < NumUnits; Unit++)
+    {
+        const FTacticsUnit& Current = Units[Unit];
+        if (Current.Team != SideToMove || !Current.IsAlive())
+        {
+            continue;
+        }
+
+        // Un'unit che non ha ancora agito pu muoversi o restare ferma
+        if (Current.Flags == 0)
+        {
+            bAllActed = false;
+
+            uint64 Reachable[MaxRows];
+            GetReachableRows(Unit, Reachable);
+            for (int32 Y = 0; Y < Rows; Y++)
+            {
+                uint64 Bits = Reachable[Y];
+                while (Bits != 0)
+                {
+                    OutActions.Add(FTacticsAction::Move(Unit, Y * Columns + (int32)FMath::CountTrailingZeros64(Bits)));
+                    Bits &= Bits - 1;
+                }
+            }
+            OutActions.Add(FTacticsAction::Pass(Unit));
+        }
+
+        // L'attacco  possibile anche dopo il movimento, ma una sola volta
+        if (!Current.HasAttacked())
+        {
+            for (int32 Target = 0; Target < NumUnits; Target++)
+            {
+                if (Units[Target].Team != SideToMove && Units[Target].IsAlive() && IsInAttackRange(Unit, Target))
+                {
+                    OutActions.Add(FTacticsAction::Attack(Unit, Target));
+                }
+            }
+        }
+    }
+
+    // Il turno passa all'altra squadra solo quando ogni unit viva ha mosso o attaccato
+    if (bAllActed)
+    {
+        OutActions.Add(FTacticsAction::EndTurn());
+    }
+    return OutActions.Num - FirstAction;
+}
+
+FTacticsUndo FTacticsState::Apply(FTacticsAction Action)
+{
+    FTacticsUndo UndoInfo;
+    UndoInfo.PreviousHash = Hash;
+    const int32 UnitIndex = Action.GetUnit();
+    FTacticsUnit& Unit = Units[UnitIndex];
+    const uint8 PreviousFlags = Unit.Flags;
+
+    switch (Action.GetType())
+    {
+    case ETacticsActionType::Move:
+        UndoInfo.FromCell = Unit.Cell;
+        Hash ^= ZobristKeys.Cell[UnitIndex][Unit.Cell] ^ ZobristKeys.Cell[UnitIndex][Action.GetCell()];
+        Unit.Cell = Action.GetCell();
+        Unit.Flags |= FTacticsUnit::MovedFlag;
+        break;
+
+    case ETacticsActionType::Pass:
+        Unit.Flags |= FTacticsUnit::MovedFlag;
+        break;
+
+    case ETacticsActionType::Attack:
+    {
+        // Come negli attori il controattacco arriva anche se il bersaglio viene eliminato
+        const int32 TargetIndex = Action.GetTarget();
+        FTacticsUnit& Target = Units[TargetIndex];
+        Hash ^= GetHealthKey(TargetIndex, Target.Health) ^ GetHealthKey(TargetIndex, Target.Health - Action.GetDamage());
+        Hash ^= GetHealthKey(UnitIndex, Unit.Health) ^ GetHealthKey(UnitIndex, Unit.Health - Action.GetCounterDamage());
+        Target.Health -= Action.GetDamage();
+        Unit.Health -= Action.GetCounterDamage();
+        Unit.Flags |= FTacticsUnit::AttackedFlag;
+        break;
+    }
+
+    case ETacticsActionType::EndTurn:
+        for (int32 Index = 0; Index < NumUnits; Index++)
+        {
+            UndoInfo.PreviousFlags[Index] = Units[Index].Flags;
+            Hash ^= ZobristKeys.Flags[Index][Units[Index].Flags] ^ ZobristKeys.Flags[Index][0];
+            Units[Index].Flags = 0;
+        }
+        SideToMove = (SideToMove == ETeamType::Player) ? ETeamType::AI : ETeamType::Player;
+        Hash ^= ZobristKeys.Side;
+        return UndoInfo;
+    }
+
+    Hash ^= ZobristKeys.Flags[UnitIndex][PreviousFlags] ^ ZobristKeys.Flags[UnitIndex][Unit.Flags];
+    return UndoInfo;
+}
+
+void FTacticsState::Undo(FTacticsAction Action, const FTacticsUndo& UndoInfo)
+{
+    FTacticsUnit& Unit = Units[Action.GetUnit()];
+
+    // Move e Pass sono legali solo per unit che non hanno agito, Attack solo per unit che non hanno attaccato
+    switch (Action.GetType())
+    {
+    case ETacticsActionType::Move:
+        Unit.Cell = UndoInfo.FromCell;
+        Unit.Flags = 0;
+        break;
+
+    case ETacticsActionType::Pass:
+        Unit.Flags = 0;
+        break;
+
+    case ETacticsActionType::Attack:
+        Units[Action.GetTarget()].Health += Action.GetDamage();
+        Unit.Health += Action.GetCounterDamage();
+        Unit.Flags &= ~FTacticsUnit::AttackedFlag;
+        break;
+
+    case ETacticsActionType::EndTurn:
+        for (int32 Index = 0; Index < NumUnits; Index++)
+        {
+            Units[Index].Flags = UndoInfo.PreviousFlags[Index];
+        }
+        SideToMove = (SideToMove == ETeamType::Player) ? ETeamType::AI : ETeamType::Player;
+        break;
+    }
+    Hash = UndoInfo.PreviousHash;
+}
+
+bool FTacticsState::InitRandom(int32 GridSize, FRandomStream& Stream)
+{
+    TArray<bool> Obstacles;
+    FGridObstacleGenerator::Generate(EGridGeneratorType::NoiseField, GridSize, GridSize, 20.0f, Stream, Obstacles);
+    if (!Init(GridSize, GridSize, Obstacles))
+    {
+        return false;
+    }
+
+    const ABaseUnit* Defaults[] = { GetDefault<ASniperUnit>(), GetDefault<ABrawlerUnit>(), GetDefault<ASniperUnit>(), GetDefault<ABrawlerUnit>() };
+    for (int32 Index = 0; Index < MaxUnits; Index++)
+    {
+        FTacticsUnit Unit = FTacticsUnit::FromUnit(Defaults[Index]);
+        Unit.Team = Index < 2 ? ETeamType::Player : ETeamType::AI;
+        Unit.Flags = 0;
+        do
+        {
+            Unit.Cell = Stream.RandRange(0, GridSize * GridSize - 1);
+        } while (Obstacles[Unit.Cell] || GetUnitAt(Unit.Cell) != INDEX_NONE);
+        AddUnit(Unit);
+    }
+    return true;
+}
+
+// Conta le posizioni raggiungibili per ogni profondit fino a Depth, partendo da una posizione casuale
+void FTacticsState::RunBenchmark(int32 GridSize, int32 Depth, int32 Seed)
+{
+    FRandomStream Stream(Seed);
+    FTacticsState State;
+    if (!State.InitRandom(GridSize, Stream))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Tactics state benchmark: a %dx%d grid is larger than the supported %dx%d"), GridSize, GridSize, MaxRows, MaxColumns);
+        return;
+    }
+
+    UE_LOG(LogTemp, Warning, TEXT("Tactics state benchmark, %dx%d grid, seed %d"), GridSize, GridSize, Seed);
+    for (int32 CurrentDepth = 1; CurrentDepth <= Depth; CurrentDepth++)
+    {
+        const double StartTime = FPlatformTime::Seconds();
+        const int64 Positions = CountPositions(State, CurrentDepth);
+        const double Seconds = FPlatformTime::Seconds() - StartTime;
+        UE_LOG(LogTemp, Warning, TEXT("Depth %d: %lld positions in %.2f ms (%.2f million positions/s)"),
+            CurrentDepth, Positions, Seconds * 1000.0, Seconds > 0.0 ? Positions / Seconds / 1000000.0 : 0.0);
+    }
+}
@@ -0,0 +1,106 @@
+#include "TacticsTranspositionTable.h"
+
+FTacticsTranspositionTable::~FTacticsTranspositionTable()
+{
+    FMemory::Free(Buckets);
+}
+
+void FTacticsTranspositionTable::Init(int32 SizeMB)
+{
+    const uint64 MaxBuckets = FMath::Max<uint64>((uint64)FMath::Max(SizeMB, 1) * 1024 * 1024 / sizeof(FBucket), 1);
+    uint64 NewNumBuckets = 1;
+    while (NewNumBuckets * 2 <= MaxBuckets)
+    {
+        NewNumBuckets *= 2;
+    }
+
+    if (NewNumBuckets != NumBuckets)
+    {
+        FMemory::Free(Buckets);
+        NumBuckets = NewNumBuckets;
+        Buckets = (FBucket*)FMemory::Malloc(NumBuckets * sizeof(FBucket), alignof(FBucket));
+    }
+    Clear();
+}
+
+void FTacticsTranspositionTable::Clear()
+{
+    // Tutti zero  una voce vuota (tipo None)
+    FMemory::Memzero(Buckets, NumBuckets * sizeof(FBucket));
+    Generation = 0;
+}
+
+uint64 FTacticsTranspositionTable::PackData(float Score, int32 Depth, ETacticsBound Bound, FTacticsAction BestAction, uint32 InGeneration)
+{
+    // Le azioni salvate non hanno esito: bastano tipo, unit e bersaglio (7 bit) e la cella (12 bit)
+    const uint64 Action = (BestAction.Bits & 0x7F) | (uint64)BestAction.GetCell() << 7;
+
+    uint32 ScoreBits;
+    FMemory::Memcpy(&ScoreBits, &Score, sizeof(ScoreBits));
+    return (uint64)ScoreBits
+        | Action << 32
+        | (uint64)FMath::Clamp(Depth, 0, MaxDepth) << 55
+        | (uint64)Bound << 60
+        | (uint64)InGeneration << 62;
+}
+
+FTacticsTableEntry FTacticsTranspositionTable::UnpackData(uint64 Data)
+{
+    FTacticsTableEntry Entry;
+    const uint32 ScoreBits = (uint32)Data;
+    FMemory::Memcpy(&Entry.Score, &ScoreBits, sizeof(ScoreBits));
+    const uint32 Action = (uint32)((Data >> 32) & 0x7FFFFF);
+    Entry.BestAction.Bits = (Action & 0x7F) | (Action >> 7) << 16;
+    Entry.Depth = GetDataDepth(Data);
+    Entry.Bound = (ETacticsBound)((Data >> 60) & 0x3);
+    return Entry;
+}
+
+bool FTacticsTranspositionTable::Probe(uint64 Key, FTacticsTableEntry& OutEntry) const
+{
+    const FBucket& Bucket = Buckets[Key & (NumBuckets - 1)];
+    for (const FEntry& Entry : Bucket.Entries)
+    {
+        const uint64 Data = Entry.Data.load(std::memory_order_relaxed);
+        if ((Entry.CheckedKey.load(std::memory_order_relaxed) ^ Data) == Key)
+        {
+            OutEntry = UnpackData(Data);
+            return OutEntry.Bound != ETacticsBound::None;
+        }
+    }
+    return false;
+}
+
+void FTacticsTranspositionTable::Store(uint64 Key, float Score, int32 Depth, ETacticsBound Bound, FTacticsAction BestAction)
+{
+    FBucket& Bucket = Buckets[Key & (NumBuckets - 1)];
+
+    // Voce da sostituire: la stessa posizione se c', altrimenti quella con priorit pi bassa
+    // (generazioni precedenti prima, poi profondit minore)
+    FEntry* Replace = &Bucket.Entries[0];
+    int32 ReplacePriority = MAX_int32;
+    for (FEntry& Entry : Bucket.Entries)
+    {
+        const uint64 Data = Entry.Data.load(std::memory_order_relaxed);
+        if ((Entry.CheckedKey.load(std::memory_order_relaxed) ^ Data) == Key)
+        {
+            // Un risultato pi profondo della stessa ricerca vale pi di quello nuovo
+            if (GetDataGeneration(Data) == Generation && GetDataDepth(Data) > Depth && Bound != ETacticsBound::Exact)
+            {
+                return;
+            }
+            Replace = &Entry;
+            break;
+        }
+        const int32 Priority = (GetDataGeneration(Data) == Generation ? 64 : 0) + GetDataDepth(Data);
+        if (Priority < ReplacePriority)
+        {
+            ReplacePriority = Priority;
+            Replace = &Entry;
+        }
+    }
+
+    const uint64 Data = PackData(Score, Depth, Bound, BestAction, Generation);
+    Replace->Data.store(Data, std::memory_order_relaxed);
+    Replace->CheckedKey.store(Key ^ Data, std::memory_order_relaxed);
+}
@@ -27,6 +27,9 @@ protected:
 
     virtual void BeginPlay() override;
 
+    // Libera la cella occupata quando l'unit viene distrutta
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 public:
 
     ABaseUnit();
@@ -66,9 +69,9 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Unit Properties")
     ETeamType TeamType;
 
-    // Riferimento alla cella occupata
-    UPROPERTY()
-    class AGridCell* CurrentCell;
+    // Indice della cella occupata nella griglia
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Grid")
+    int32 CurrentCellIndex = INDEX_NONE;
 
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Movement")
     bool bHasMoved = false;
@@ -81,13 +84,16 @@ public:
     virtual void Initialize(EUnitType Type, ETeamType Team);
 
     UFUNCTION(BlueprintCallable, Category = "Unit Actions")
-    virtual void PlaceOnGrid(class AGridCell* Cell);
+    virtual void PlaceOnGrid(int32 CellIndex);
 
     UFUNCTION()
     void OnUnitClicked(UPrimitiveComponent* TouchedComponent, FKey ButtonPressed);
 
     UFUNCTION(BlueprintCallable, Category = "Unit Movement")
-    void MoveToCell(AGridCell* NewCell);
+    void MoveToCell(int32 NewCellIndex);
+
+    // Segue un percorso gi calcolato senza ripetere la ricerca
+    void MoveAlongPath(const TArray<int32>& Path);
 
     UFUNCTION(BlueprintCallable, Category = "Unit Actions")
     void AttackTarget(ABaseUnit* Target);
@@ -98,7 +104,7 @@ public:
 
     int32 PendingCounterDamage;
 
-    TArray<AGridCell*> MovementPath;
+    TArray<int32> MovementPath;
 
     int32 CurrentPathIndex = 0;
 
@@ -108,7 +114,11 @@ public:
 
 	void MoveStep();    
 
-    TArray<AGridCell*>ComputePath(AGridCell* Start, AGridCell* Goal);
+    void OnMovePathReady(const TArray<int32>& Path, int32 FromCellIndex);
+
+    void OccupyCell(class AGridManager* GridManager, int32 NewCellIndex);
+
+    void StartMovement(const TArray<int32>& Path);
 
     void PerformDummyMove();
 };
\ No newline at end of file
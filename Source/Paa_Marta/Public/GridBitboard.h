@@ -0,0 +1,98 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Insieme di celle della griglia memorizzato come una maschera di bit per riga (parole da 64 bit, bit X della riga Y).
+// Le espansioni di una BFS sui 4 vicini diventano shift e maschere applicati a intere parole, quindi un intero
+// strato della visita costa poche operazioni per riga invece di un controllo per cella
+class PAA_MARTA_API FGridBitboard
+{
+public:
+
+    // Prepara una griglia vuota; se le dimensioni non cambiano la memoria gi allocata viene riusata
+    void Init(int32 InRows, int32 InColumns);
+
+    // Svuota l'insieme senza liberare memoria: vengono azzerate solo le righe in cui sono stati messi dei bit
+    void Reset();
+
+    FORCEINLINE int32 GetRows() const { return Rows; }
+    FORCEINLINE int32 GetColumns() const { return Columns; }
+
+    FORCEINLINE bool Test(int32 Cell) const
+    {
+        const int32 X = Cell % Columns;
+        return (Words[(Cell / Columns) * WordsPerRow + (X >> 6)] >> (X & 63)) & 1;
+    }
+
+    FORCEINLINE void Set(int32 Cell)
+    {
+        const int32 X = Cell % Columns;
+        const int32 Y = Cell / Columns;
+        Words[Y * WordsPerRow + (X >> 6)] |= uint64(1) << (X & 63);
+        MarkRowsUsed(Y, Y);
+    }
+
+    FORCEINLINE void Clear(int32 Cell)
+    {
+        const int32 X = Cell % Columns;
+        Words[(Cell / Columns) * WordsPerRow + (X >> 6)] &= ~(uint64(1) << (X & 63));
+    }
+
+    FORCEINLINE void SetTo(int32 Cell, bool bValue)
+    {
+        if (bValue)
+        {
+            Set(Cell);
+        }
+        else
+        {
+            Clear(Cell);
+        }
+    }
+
+    int32 CountSetBits() const;
+
+    // Chiama Functor(Cell) per ogni cella dell'insieme, in ordine di indice, saltando le parole vuote
+    template<typename FunctorType>
+    void ForEachSetBit(FunctorType&& Functor) const
+    {
+        for (int32 Y = FirstUsedRow; Y <= LastUsedRow; Y++)
+        {
+            for (int32 Word = 0; Word < WordsPerRow; Word++)
+            {
+                uint64 Bits = Words[Y * WordsPerRow + Word];
+                while (Bits != 0)
+                {
+                    const int32 X = (Word << 6) + (int32)FMath::CountTrailingZeros64(Bits);
+                    Functor(Y * Columns + X);
+                    Bits &= Bits - 1;
+                }
+            }
+        }
+    }
+
+    // Celle raggiungibili da Origin in al pi Range passi sulle celle di Passable (Origin pu non esserlo).
+    // OutLayers[D] contiene le celle a distanza esattamente D; OutReached tutte quelle raggiunte, esclusa Origin.
+    // Lo strato D tocca solo le righe e le parole entro D celle dalla partenza, quindi il costo dipende dal raggio
+    static void FloodFill(const FGridBitboard& Passable, int32 Origin, int32 Range, FGridBitboard& OutReached, TArray<FGridBitboard>& OutLayers);
+
+    // Confronta nel log la BFS cella per cella con il riempimento a bit per i raggi di movimento delle unit
+    static void RunBenchmark(const TArray<int32>& GridSizes, int32 QueriesPerSize, int32 Seed);
+
+private:
+
+    FORCEINLINE void MarkRowsUsed(int32 MinY, int32 MaxY)
+    {
+        FirstUsedRow = FMath::Min(FirstUsedRow, MinY);
+        LastUsedRow = FMath::Max(LastUsedRow, MaxY);
+    }
+
+    int32 Rows = 0;
+    int32 Columns = 0;
+    int32 WordsPerRow = 0;
+    TArray<uint64> Words;
+
+    // Righe che possono contenere bit a 1: fuori da questo intervallo le parole sono tutte a zero
+    int32 FirstUsedRow = 0;
+    int32 LastUsedRow = -1;
+};
@@ -16,21 +16,10 @@ public:
 
     AGridCell();
 
-    // Flag per indicare se la cella  un ostacolo
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid")
-    bool bIsObstacle;
-
     // Componente mesh per la cella
     UPROPERTY(VisibleAnywhere, Category = "Components")
     UStaticMeshComponent* MeshComponent;
 
-    // Propriet di occupazione
-    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Grid")
-    bool bIsOccupied;
-
-    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Grid")
-    class ABaseUnit* OccupyingUnit;
-
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Materials")
     UMaterialInterface* NormalMaterial;
 
@@ -47,12 +36,12 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid")
     int32 GridY;
 
-    UFUNCTION(BlueprintCallable, Category = "Grid")
-    void InitializeCell(bool bInIsObstacle, const FVector& CellSize, UMaterialInterface* InNormalMaterial, UMaterialInterface* InObstacleMaterial);
+    // Indice della cella nei dati del GridManager (ostacoli e occupazione sono salvati l)
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Grid")
+    int32 CellIndex;
 
-    // Funzioni per la gestione dell'occupazione
     UFUNCTION(BlueprintCallable, Category = "Grid")
-    void SetOccupied(bool bOccupied);
+    void InitializeCell(bool bInIsObstacle, const FVector& CellSize, UMaterialInterface* InNormalMaterial, UMaterialInterface* InObstacleMaterial);
 
     // Funzioni per la selezione 
     UFUNCTION(BlueprintCallable, Category = "Grid")
@@ -64,6 +53,7 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Grid")
     void OnCellUnhovered();
 
+    // Evidenziazione con un materiale per cella, usata dal GridManager quando i materiali non leggono la texture
     UFUNCTION()
     void HighlightCell(const FLinearColor& Color);
 
@@ -79,5 +69,9 @@ private:
     UPROPERTY()
     UStaticMeshComponent* InfoBox;
 
+    // Materiale della cella quando non  evidenziata
+    UPROPERTY()
+    UMaterialInterface* BaseMaterial;
+
     bool bIsInfoBoxVisible;
 };
\ No newline at end of file
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Distanze a piedi tra tutte le coppie di celle libere, calcolate una volta sola perch gli ostacoli non cambiano.
+// Considera solo gli ostacoli: l'occupazione delle unit va controllata da chi segue i passi della tabella.
+// La memoria cresce con il quadrato delle celle libere, quindi  pensata per griglie fino a circa 64x64
+struct PAA_MARTA_API FGridDistanceTable
+{
+    // Valore salvato per le coppie di celle non collegate
+    static constexpr uint16 Unreachable = MAX_uint16;
+
+    // Calcola la tabella con una BFS per ogni cella libera, distribuite sui thread del task graph
+    void Build(int32 InRows, int32 InColumns, const TArray<bool>& Obstacles);
+
+    FORCEINLINE bool IsBuilt() const { return NumFreeCells > 0; }
+
+    // Distanza a piedi tra due celle in O(1) (INDEX_NONE se una delle due  un ostacolo o non sono collegate)
+    FORCEINLINE int32 GetDistance(int32 From, int32 To) const
+    {
+        const int32 FromFree = FreeIndex[From];
+        const int32 ToFree = FreeIndex[To];
+        if (FromFree == INDEX_NONE || ToFree == INDEX_NONE)
+        {
+            return INDEX_NONE;
+        }
+        const uint16 Distance = Distances[FromFree * NumFreeCells + ToFree];
+        return Distance == Unreachable ? INDEX_NONE : Distance;
+    }
+
+    // Vicino di From un passo pi vicino a To, letto dalla tabella senza ricerche (INDEX_NONE se From == To o non collegate)
+    int32 GetNextStep(int32 From, int32 To) const;
+
+    // Percorso minimo da From a To (estremi inclusi) ottenuto scendendo lungo la tabella
+    bool GetPath(int32 From, int32 To, TArray<int32>& OutPath) const;
+
+    // Memoria occupata dalla tabella e dagli indici, in byte
+    SIZE_T GetAllocatedSize() const;
+
+    FORCEINLINE int32 GetNumFreeCells() const { return NumFreeCells; }
+
+    // Misura tempo di costruzione e memoria per ogni dimensione di griglia e li scrive nel log
+    static void RunBenchmark(const TArray<int32>& GridSizes, float ObstaclePercentage, int32 Seed);
+
+private:
+
+    int32 Rows = 0;
+    int32 Columns = 0;
+    int32 NumFreeCells = 0;
+
+    // Indice compatto di ogni cella libera (INDEX_NONE per gli ostacoli) e cella corrispondente a ogni indice compatto
+    TArray<int32> FreeIndex;
+    TArray<int32> FreeCells;
+
+    // Una riga di NumFreeCells distanze per ogni cella libera di partenza
+    TArray<uint16> Distances;
+};
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Campo di distanze verso una cella obiettivo, calcolato con una sola BFS e letto in O(1) da tutte le unit
+// che vogliono raggiungerla. Considera solo gli ostacoli: le unit si spostano durante il turno,
+// quindi l'occupazione va controllata mentre si segue il campo
+struct PAA_MARTA_API FGridFlowField
+{
+    // Cella da cui  partita la BFS
+    int32 TargetCell = INDEX_NONE;
+
+    // Passi a piedi da ogni cella all'obiettivo (INDEX_NONE se la cella non lo pu raggiungere)
+    TArray<int32> Distance;
+
+    // Cella successiva lungo un percorso minimo verso l'obiettivo (INDEX_NONE per l'obiettivo e le celle irraggiungibili)
+    TArray<int32> NextCell;
+
+    // Ricalcola il campo per l'obiettivo indicato, riusando i buffer gi allocati e la frontiera del contesto
+    void Build(int32 Rows, int32 Columns, const TArray<bool>& Obstacles, int32 Target, struct FGridSearchContext& Context);
+
+    FORCEINLINE bool IsReachable(int32 Cell) const { return Distance[Cell] != INDEX_NONE; }
+    FORCEINLINE int32 GetDistance(int32 Cell) const { return Distance[Cell]; }
+    FORCEINLINE int32 GetNextCell(int32 Cell) const { return NextCell[Cell]; }
+};
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GridGenerator.generated.h"
+
+// Algoritmo usato per piazzare gli ostacoli
+UENUM()
+enum class EGridGeneratorType : uint8
+{
+    // Ostacoli in ordine casuale, ognuno accettato solo se non crea isole
+    Incremental UMETA(DisplayName = "Incremental"),
+    // Campo di rumore sogliato in una passata, poi le zone isolate vengono collegate con corridoi
+    NoiseField UMETA(DisplayName = "Noise Field")
+};
+
+// Metriche di qualit di una mappa generata, usate per scegliere tra pi candidate
+struct FGridMapScore
+{
+    // Ostacoli piazzati rispetto a quelli richiesti (1 = percentuale raggiunta)
+    float ObstacleRatio = 0.f;
+
+    // Area (in celle) del pi grande quadrato senza ostacoli
+    int32 LargestOpenArea = 0;
+
+    // Celle libere di corridoio: due soli vicini liberi, opposti tra loro
+    int32 Chokepoints = 0;
+
+    // Punteggio complessivo, pi alto  migliore
+    float Total = 0.f;
+};
+
+// Generatore degli ostacoli della griglia: lavora su un array piatto (indice = Y * Columns + X)
+// e non dipende dagli attori, cos pu essere usato anche dal benchmark
+struct PAA_MARTA_API FGridObstacleGenerator
+{
+    // Piazza gli ostacoli senza creare isole e restituisce il numero di ostacoli piazzati.
+    // Tutta la casualit viene dallo stream: con lo stesso seed la disposizione  sempre identica
+    static int32 GenerateObstacles(int32 Rows, int32 Columns, float ObstaclePercentage, FRandomStream& Stream, TArray<bool>& OutObstacles);
+
+    // Genera gli ostacoli con l'algoritmo indicato
+    static int32 Generate(EGridGeneratorType Type, int32 Rows, int32 Columns, float ObstaclePercentage, FRandomStream& Stream, TArray<bool>& OutObstacles);
+
+    // Ostacoli dove un campo di rumore levigato supera la soglia che d esattamente la percentuale richiesta,
+    // poi le zone libere isolate vengono collegate: costo lineare nel numero di celle
+    static int32 GenerateNoiseObstacles(int32 Rows, int32 Columns, float ObstaclePercentage, FRandomStream& Stream, TArray<bool>& OutObstacles);
+
+    // Genera NumCandidates mappe in parallelo, ognuna con un proprio seed derivato dallo stream,
+    // e tiene quella con il punteggio migliore. Il risultato dipende solo dallo stream, non dall'ordine dei thread
+    static int32 GenerateBestObstacles(EGridGeneratorType Type, int32 Rows, int32 Columns, float ObstaclePercentage, int32 NumCandidates, FRandomStream& Stream,
+        TArray<bool>& OutObstacles, FGridMapScore& OutScore);
+
+    // Calcola le metriche di qualit della mappa
+    static FGridMapScore ScoreMap(int32 Rows, int32 Columns, float ObstaclePercentage, const TArray<bool>& Obstacles);
+
+    // Verifica completa con una BFS che tutte le celle libere siano connesse
+    static bool IsGridFullyConnected(int32 Rows, int32 Columns, const TArray<bool>& Obstacles);
+
+    // Misura il tempo di generazione per ogni dimensione di griglia indicata e lo scrive nel log
+    static void RunBenchmark(const TArray<int32>& GridSizes, float ObstaclePercentage, int32 Seed);
+
+private:
+
+    // Buffer riutilizzati dalla ricerca di fallback per non allocare ad ogni ostacolo
+    struct FFallbackScratch
+    {
+        TArray<uint32> VisitStamp;
+        TArray<uint8> Owner;
+        TArray<int32> Queues[4];
+        uint32 Stamp = 0;
+    };
+
+    // Test locale: i vicini liberi della cella restano connessi attraverso le 8 celle che la circondano
+    static bool IsLocallySafe(int32 Rows, int32 Columns, const TArray<bool>& Obstacles, int32 X, int32 Y);
+
+    // Ricerca di fallback: una BFS per ogni vicino libero, espanse a turno, che si ferma appena le frontiere
+    // si incontrano (connesse) o appena un gruppo esaurisce la propria frontiera (isola)
+    static bool AreNeighborsConnected(int32 Rows, int32 Columns, const TArray<bool>& Obstacles, int32 X, int32 Y, FFallbackScratch& Scratch);
+
+    // Etichetta una volta le zone libere e collega ogni zona isolata a quelle gi collegate scavando il corridoio
+    // che attraversa meno ostacoli (BFS 0-1). Restituisce il numero di ostacoli rimossi
+    static int32 RepairConnectivity(int32 Rows, int32 Columns, TArray<bool>& Obstacles);
+
+    // Versione originale con una BFS completa per ogni ostacolo, usata solo come confronto nel benchmark
+    static int32 GenerateObstaclesFullCheck(int32 Rows, int32 Columns, float ObstaclePercentage, FRandomStream& Stream, TArray<bool>& OutObstacles);
+};
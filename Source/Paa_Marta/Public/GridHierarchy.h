@@ -0,0 +1,103 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FGridSearchContext;
+
+// Ricerca gerarchica (HPA*) per griglie grandi: la griglia  divisa in cluster quadrati, i passaggi liberi tra
+// cluster vicini diventano nodi di un grafo astratto e le distanze tra i nodi dello stesso cluster sono precalcolate.
+// Una ricerca lunga esplora solo il grafo astratto e poi ricostruisce il percorso cella per cella dentro i cluster
+// attraversati. Il percorso  quasi minimo (i passaggi sono scelti in punti fissi dei bordi).
+// Ostacoli e occupazione bloccano il passaggio: quando l'occupazione cambia vengono ricalcolati solo i cluster coinvolti
+class PAA_MARTA_API FGridHierarchy
+{
+public:
+
+    // Costruisce tutti i cluster sullo stato attuale della griglia
+    void Build(int32 InRows, int32 InColumns, int32 InClusterSize, const TArray<bool>& Obstacles, const TArray<bool>& Occupied);
+
+    FORCEINLINE bool IsBuilt() const { return Clusters.Num() > 0; }
+
+    // Segna da ricalcolare il cluster della cella e, se la cella  sul bordo, anche il cluster confinante
+    void MarkCellChanged(int32 Cell);
+
+    // Ricalcola i cluster segnati e restituisce quanti sono stati ricostruiti
+    int32 UpdateDirtyClusters(const TArray<bool>& Obstacles, const TArray<bool>& Occupied);
+
+    // Percorso da Start a Goal (estremi inclusi) con le stesse regole di FGridPathfinder::FindPath: Goal pu
+    // essere occupato. Le richieste tra celle vicine vengono passate direttamente all'A* sulla griglia
+    bool FindPath(const TArray<bool>& Obstacles, const TArray<bool>& Occupied, int32 Start, int32 Goal,
+        FGridSearchContext& Context, TArray<int32>& OutPath);
+
+    int32 GetNumNodes() const;
+
+    // Confronta tempo e lunghezza dei percorsi con l'A* sulla griglia e scrive i risultati nel log
+    static void RunBenchmark(const TArray<int32>& GridSizes, int32 ClusterSize, int32 QueriesPerSize, int32 Seed);
+
+private:
+
+    // Cella di bordo di un cluster che ha almeno un passaggio verso un cluster vicino
+    struct FNode
+    {
+        int32 Cell = INDEX_NONE;
+
+        // Celle dall'altra parte del bordo raggiungibili con un passo (pi di una solo negli angoli)
+        TArray<int32, TInlineAllocator<2>> Partners;
+    };
+
+    struct FCluster
+    {
+        int32 MinX = 0;
+        int32 MinY = 0;
+        int32 MaxX = 0;
+        int32 MaxY = 0;
+
+        TArray<FNode> Nodes;
+
+        // Distanza dentro al cluster tra ogni coppia di nodi (Nodes.Num() x Nodes.Num(), INDEX_NONE se non collegati)
+        TArray<int32> NodeDistances;
+
+        bool bDirty = false;
+    };
+
+    FORCEINLINE int32 GetClusterIndex(int32 Cell) const
+    {
+        return ((Cell / Columns) / ClusterSize) * ClusterCountX + (Cell % Columns) / ClusterSize;
+    }
+
+    // Ricalcola nodi e distanze interne del cluster
+    void RebuildCluster(int32 ClusterIndex, const TArray<bool>& Obstacles, const TArray<bool>& Occupied);
+
+    // Aggiunge al cluster i nodi dei passaggi verso il cluster vicino nella direzione indicata (0 = N, 1 = E, 2 = S, 3 = W).
+    // I passaggi dipendono solo dalle celle del bordo, quindi i due cluster confinanti li trovano sempre uguali
+    void AddBorderNodes(FCluster& Cluster, int32 Direction, const TArray<bool>& Obstacles, const TArray<bool>& Occupied);
+
+    // BFS limitata al cluster a partire da Source (sempre espansa). ExtraPassable pu essere attraversata anche se occupata.
+    // Riempie LocalDistance e LocalParent, indicizzati per posizione locale nel cluster
+    void SearchCluster(const FCluster& Cluster, int32 Source, int32 ExtraPassable, const TArray<bool>& Obstacles, const TArray<bool>& Occupied);
+
+    FORCEINLINE int32 ToLocal(const FCluster& Cluster, int32 Cell) const
+    {
+        return ((Cell / Columns) - Cluster.MinY) * ClusterSize + (Cell % Columns) - Cluster.MinX;
+    }
+
+    int32 Rows = 0;
+    int32 Columns = 0;
+    int32 ClusterSize = 0;
+    int32 ClusterCountX = 0;
+    int32 ClusterCountY = 0;
+
+    TArray<FCluster> Clusters;
+    TArray<int32> DirtyClusters;
+
+    // Posizione nella lista dei nodi del proprio cluster per le celle che sono nodi (INDEX_NONE per le altre)
+    TArray<int32> CellNodeIndex;
+
+    // Buffer riutilizzati dalle ricerche dentro un cluster e dalla ricerca astratta
+    TArray<int32> LocalDistance;
+    TArray<int32> LocalParent;
+    TArray<int32> LocalFrontier;
+    TArray<int32> StartLinks;
+    TArray<int32> GoalLinks;
+    TArray<int32> AbstractPath;
+};
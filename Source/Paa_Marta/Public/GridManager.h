@@ -5,9 +5,90 @@
 #include "Containers/Set.h"
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "GridGenerator.h"
+#include "GridSearchContext.h"
+#include "GridPathService.h"
+#include "GridDistanceTable.h"
+#include "GridBitboard.h"
+#include "GridRangeTables.h"
+#include "GridHierarchy.h"
+#include "GridPathfinder.h"
+#include "Tasks/Task.h"
 #include "GridManager.generated.h"
 
 class AGridCell;
+class ABaseUnit;
+class UInstancedStaticMeshComponent;
+class UMaterialInstanceDynamic;
+class UTexture2D;
+
+// Modalit di rappresentazione della griglia
+UENUM()
+enum class EGridRenderMode : uint8
+{
+    // Un attore AGridCell per ogni cella (comportamento originale)
+    CellActors UMETA(DisplayName = "Cell Actors"),
+    // Poche componenti instanziate, le celle sono solo dati nel GridManager
+    Instanced UMETA(DisplayName = "Instanced"),
+    // Come Instanced, ma solo i chunk vicini alla telecamera hanno una rappresentazione visiva
+    Streamed UMETA(DisplayName = "Streamed")
+};
+
+// Aspetto della cella, scelto una sola volta durante l'inizializzazione
+enum class EGridCellVisual : uint8
+{
+    Normal,
+    Tree,
+    Mountain
+};
+
+// Vicini ortogonali di una cella (al massimo 4), senza allocazioni sull'heap
+typedef TArray<int32, TInlineAllocator<4>> FGridNeighbors;
+
+// Dati della griglia calcolati in background prima della creazione delle celle
+struct FGridLayout
+{
+    // Parametri, copiati dal GridManager all'avvio della generazione
+    int32 Rows = 0;
+    int32 Columns = 0;
+    float ObstaclePercentage = 0.f;
+    EGridGeneratorType GeneratorType = EGridGeneratorType::Incremental;
+    int32 MapCandidates = 1;
+    int32 Seed = 0;
+    int32 ChunkSize = 1;
+    bool bUseMountains = false;
+    bool bBuildDistanceTable = false;
+
+    // Risultati
+    TArray<bool> Obstacles;
+    TArray<EGridCellVisual> Visuals;
+    int32 PlacedObstacles = 0;
+    FGridMapScore Score;
+    FGridDistanceTable DistanceTable;
+    double DistanceTableBuildMs = 0.0;
+    int32 HierarchyClusterSize = 0;
+    FGridHierarchy Hierarchy;
+    double HierarchyBuildMs = 0.0;
+};
+
+// Celle raggiungibili da una cella di partenza entro un certo numero di passi, calcolate a strati su maschere di bit.
+// L'area viene usata dalla cache solo finch l'occupazione della griglia non cambia
+struct FGridReachableArea
+{
+    int32 Origin = INDEX_NONE;
+    int32 Range = 0;
+    uint32 Version = 0;
+
+    // Celle raggiungibili, esclusa la partenza
+    FGridBitboard Cells;
+
+    // Layers[D] contiene le celle a distanza esattamente D: risalendo gli strati si ricostruisce un percorso minimo
+    TArray<FGridBitboard> Layers;
+};
+
+// Evento lanciato quando tutte le celle della griglia sono state create
+DECLARE_MULTICAST_DELEGATE(FOnGridReady);
+
 struct FGridPosition
 {
     int32 X;
@@ -45,7 +126,7 @@ protected:
     virtual void BeginPlay() override;
 
 public:
-    // Array di celle
+    // Array di celle, indicizzato come i dati della griglia (Y * GridColumns + X)
     UPROPERTY()
     TArray<class AGridCell*> GridCells;
 
@@ -65,11 +146,87 @@ public:
     UPROPERTY(EditAnywhere, Category = "Grid")
     FVector CellSize = FVector(100.0f, 100.0f, 10.0f);
 
+    // Margine tra le celle
+    UPROPERTY(EditAnywhere, Category = "Grid")
+    float CellMargin = 10.0f;
+
     // Percentuale di celle che saranno ostacoli
     UPROPERTY(EditAnywhere, Category = "Grid", meta = (ClampMin = "0.0", ClampMax = "100.0"))
     float ObstaclePercentage = 20.0f;
 
-    // Materiali per le celle 
+    // Algoritmo di generazione degli ostacoli
+    UPROPERTY(EditAnywhere, Category = "Grid")
+    EGridGeneratorType GeneratorType = EGridGeneratorType::Incremental;
+
+    // Seed della generazione della mappa: con lo stesso seed la disposizione degli ostacoli  identica.
+    // 0 = seed casuale. Pu essere sovrascritto dalla riga di comando con -GridSeed=N
+    UPROPERTY(EditAnywhere, Category = "Grid")
+    int32 GridSeed = 0;
+
+    // Numero di mappe candidate generate in parallelo: viene tenuta quella con il punteggio migliore (1 = una sola mappa)
+    UPROPERTY(EditAnywhere, Category = "Grid", meta = (ClampMin = "1", ClampMax = "64"))
+    int32 MapCandidates = 1;
+
+    // Dopo la generazione precalcola le distanze tra tutte le coppie di celle libere, cos l'IA legge distanze
+    // e passi senza ricerche. Viene fatto solo se la griglia non supera DistanceTableMaxCells celle
+    UPROPERTY(EditAnywhere, Category = "Grid|Pathfinding")
+    bool bBuildDistanceTable = true;
+
+    // 4096 celle (64x64) corrispondono a circa 32 MB di tabella
+    UPROPERTY(EditAnywhere, Category = "Grid|Pathfinding", meta = (ClampMin = "1", ClampMax = "16384"))
+    int32 DistanceTableMaxCells = 4096;
+
+    // Algoritmo usato dal servizio dei percorsi per i percorsi delle unit cercati direttamente sulla griglia
+    UPROPERTY(EditAnywhere, Category = "Grid|Pathfinding")
+    EGridPathAlgorithm PathAlgorithm = EGridPathAlgorithm::AStar;
+
+    // Sulle griglie con almeno HierarchyMinCells celle (e senza tabella delle distanze) i percorsi lunghi
+    // vengono cercati su un grafo di cluster invece che cella per cella
+    UPROPERTY(EditAnywhere, Category = "Grid|Pathfinding", meta = (ClampMin = "1"))
+    int32 HierarchyMinCells = 10000;
+
+    // Lato in celle di un cluster del grafo gerarchico
+    UPROPERTY(EditAnywhere, Category = "Grid|Pathfinding", meta = (ClampMin = "4", ClampMax = "64"))
+    int32 HierarchyClusterSize = 16;
+
+    // Modalit di rappresentazione: con Instanced le celle non vengono spawnate come attori
+    UPROPERTY(EditAnywhere, Category = "Grid")
+    EGridRenderMode RenderMode = EGridRenderMode::CellActors;
+
+    // Componenti instanziate usate in modalit Instanced, una per ogni materiale
+    UPROPERTY(VisibleAnywhere, Category = "Components")
+    UInstancedStaticMeshComponent* NormalCellsISM;
+
+    UPROPERTY(VisibleAnywhere, Category = "Components")
+    UInstancedStaticMeshComponent* TreeCellsISM;
+
+    UPROPERTY(VisibleAnywhere, Category = "Components")
+    UInstancedStaticMeshComponent* MountainCellsISM;
+
+    // Lato (in celle) dei chunk in cui viene divisa la griglia per lo streaming
+    UPROPERTY(EditAnywhere, Category = "Grid|Streaming", meta = (ClampMin = "4"))
+    int32 ChunkSize = 32;
+
+    // Chunk caricati in pi attorno all'area inquadrata dalla telecamera
+    UPROPERTY(EditAnywhere, Category = "Grid|Streaming", meta = (ClampMin = "0"))
+    int32 ChunkStreamingMargin = 1;
+
+    // Numero massimo di chunk caricati per frame, per evitare picchi durante lo spostamento della telecamera
+    UPROPERTY(EditAnywhere, Category = "Grid|Streaming", meta = (ClampMin = "1"))
+    int32 MaxChunkLoadsPerFrame = 8;
+
+    // Tempo massimo per frame dedicato alla creazione delle celle (millisecondi)
+    UPROPERTY(EditAnywhere, Category = "Grid", meta = (ClampMin = "0.1"))
+    float SpawnBudgetMs = 4.0f;
+
+    // Box informativo condiviso, mostrato sopra la cella sotto il cursore in modalit Instanced
+    UPROPERTY(VisibleAnywhere, Category = "Components")
+    UStaticMeshComponent* HoverInfoBox;
+
+    // Materiali per le celle. Se espongono il parametro texture "HighlightTexture" (RGB = colore, A = intensit)
+    // e il parametro vettore "HighlightBounds" (X, Y = angolo della griglia nel mondo, Z, W = dimensioni), con cui
+    // calcolano le UV dalla posizione nel mondo, l'evidenziazione viene letta da una texture con un texel per cella.
+    // Altrimenti si usa il parametro "BaseColor": un materiale per cella con gli attori, lastre colorate con le istanze
     UPROPERTY(EditAnywhere, Category = "Materials")
     UMaterialInterface* NormalMaterial;
 
@@ -82,14 +239,262 @@ public:
 
     FORCEINLINE const TArray<AGridCell*>& GetGridCells() const { return GridCells; };
 
+    // Lanciato quando la griglia  pronta: dati generati e celle create
+    FOnGridReady OnGridReady;
+
+    FORCEINLINE bool IsGridReady() const { return bGridReady; }
+
+    // Seed usato per generare la griglia corrente
+    FORCEINLINE int32 GetActiveGridSeed() const { return ActiveGridSeed; }
+
+    // Accesso O(1) ai dati della griglia tramite indice (Y * GridColumns + X)
+    FORCEINLINE int32 GetNumCells() const { return CellObstacles.Num(); }
+    FORCEINLINE bool IsValidCell(int32 Index) const { return CellObstacles.IsValidIndex(Index); }
+    FORCEINLINE int32 GetCellX(int32 Index) const { return Index % GridColumns; }
+    FORCEINLINE int32 GetCellY(int32 Index) const { return Index / GridColumns; }
+
+    FORCEINLINE int32 GetCellIndex(int32 X, int32 Y) const
+    {
+        return (X >= 0 && X < GridColumns && Y >= 0 && Y < GridRows) ? Y * GridColumns + X : INDEX_NONE;
+    }
+
+    FORCEINLINE bool IsObstacle(int32 Index) const { return CellObstacles[Index]; }
+    FORCEINLINE bool IsOccupied(int32 Index) const { return CellOccupied[Index]; }
+    FORCEINLINE bool IsWalkable(int32 Index) const { return !CellObstacles[Index] && !CellOccupied[Index]; }
+    FORCEINLINE ABaseUnit* GetOccupyingUnit(int32 Index) const { return CellUnits[Index]; }
+
+    // Array piatti di ostacoli e occupazione, letti direttamente dalla ricerca di percorsi
+    FORCEINLINE const TArray<bool>& GetObstacleData() const { return CellObstacles; }
+    FORCEINLINE const TArray<bool>& GetOccupiedData() const { return CellOccupied; }
+
+    // Buffer condivisi da tutte le ricerche sulla griglia (vedi FGridSearchContext)
+    FORCEINLINE FGridSearchContext& GetSearchContext() { return SearchContext; }
+
+    // Tabella delle distanze tra tutte le celle libere (nullptr se non  stata costruita per questa griglia)
+    FORCEINLINE const FGridDistanceTable* GetDistanceTable() const { return DistanceTable.IsBuilt() ? &DistanceTable : nullptr; }
+
+    // Grafo gerarchico per i percorsi lunghi (nullptr se la griglia  troppo piccola per usarlo)
+    FORCEINLINE FGridHierarchy* GetHierarchy() { return Hierarchy.IsBuilt() ? &Hierarchy : nullptr; }
+
+    // Versione dell'occupazione: cambia ad ogni posizionamento, movimento o rimozione di un'unit
+    FORCEINLINE uint32 GetOccupancyVersion() const { return OccupancyVersion; }
+
+    // Celle raggiungibili da Origin in al pi Range passi su celle libere. Il risultato resta in cache finch
+    // l'occupazione non cambia, quindi richieste ripetute sullo stesso stato della griglia non rifanno la BFS
+    const FGridReachableArea& GetReachableArea(int32 Origin, int32 Range);
+
+    // Percorso da Origin a Goal letto dagli strati di un'area in cache, senza nuove ricerche (false se non disponibile)
+    bool GetCachedPath(int32 Origin, int32 Goal, TArray<int32>& OutPath) const;
+
+    // Invalida le aree raggiungibili in cache del turno (i loro buffer restano allocati)
+    void ResetTurnSearchResults();
+
+    // Restituisce l'attore della cella in posizione (X, Y)
+    AGridCell* GetCell(int32 X, int32 Y) const;
+
+    // Restituisce gli indici dei vicini ortogonali dentro la griglia
+    FGridNeighbors GetNeighbors(int32 Index) const;
+
+    // Distanza Manhattan tra due celle
+    int32 GetDistance(int32 IndexA, int32 IndexB) const;
+
+    // Chiama Functor(Cell) per ogni cella della griglia nel rombo di raggio Range attorno a Origin, riga per riga.
+    // Per i raggi delle unit le righe vengono dalle tabelle precalcolate, e se il rombo  tutto dentro la griglia
+    // non serve nessun controllo sui bordi: il costo dipende solo dal raggio
+    template<typename FunctorType>
+    void ForEachCellInRange(int32 Origin, int32 Range, FunctorType&& Functor) const
+    {
+        const int32 OriginX = GetCellX(Origin);
+        const int32 OriginY = GetCellY(Origin);
+        const FGridDiamondView Diamond = FGridRangeTables::GetDiamond(Range);
+
+        if (Diamond.IsValid() && OriginX >= Range && OriginX + Range < GridColumns && OriginY >= Range && OriginY + Range < GridRows)
+        {
+            for (int32 Cell = 0; Cell < Diamond.NumCells; Cell++)
+            {
+                Functor(Origin + Diamond.OffsetY[Cell] * GridColumns + Diamond.OffsetX[Cell]);
+            }
+            return;
+        }
+
+        // Vicino ai bordi ogni riga del rombo viene tagliata alle colonne della griglia
+        for (int32 Y = FMath::Max(OriginY - Range, 0); Y <= FMath::Min(OriginY + Range, GridRows - 1); Y++)
+        {
+            const int32 DeltaY = Y - OriginY;
+            const int32 RowRange = Diamond.IsValid() ? Diamond.HalfWidth[DeltaY + Range] : Range - FMath::Abs(DeltaY);
+            const int32 MaxX = FMath::Min(OriginX + RowRange, GridColumns - 1);
+            for (int32 X = FMath::Max(OriginX - RowRange, 0); X <= MaxX; X++)
+            {
+                Functor(Y * GridColumns + X);
+            }
+        }
+    }
+
+    // Posizione nel mondo del centro della cella
+    FVector GetCellLocation(int32 Index) const;
+
+    // Cella che contiene il punto indicato (INDEX_NONE se il punto cade fuori dalla griglia o nel margine)
+    int32 GetCellIndexFromLocation(const FVector& Location) const;
+
+    // Cella colpita da un raggio, calcolata intersecando il piano superiore della griglia
+    int32 GetCellIndexFromRay(const FVector& RayOrigin, const FVector& RayDirection) const;
+
+    FORCEINLINE bool IsInstanced() const { return RenderMode != EGridRenderMode::CellActors; }
+    FORCEINLINE bool IsStreamed() const { return RenderMode == EGridRenderMode::Streamed; }
+
+    // Unico punto in cui viene modificata l'occupazione delle celle
+    void SetCellOccupant(int32 Index, ABaseUnit* Unit);
+    void ClearCellOccupant(int32 Index);
+
+    // Richiede in background il percorso minimo da Start a Goal lungo al pi MaxCost passi (INDEX_NONE = nessun limite).
+    // La ricerca usa lo stato della griglia al momento della richiesta e la callback arriva sul game thread
+    int32 RequestPath(int32 Start, int32 Goal, int32 MaxCost, FOnGridPathReady Callback);
+    void CancelPathRequest(int32 Handle);
+
+    // Evidenziazione delle celle
+    void HighlightCell(int32 Index, const FLinearColor& Color);
+    void ResetCellHighlight(int32 Index);
+
+    // Mostra o nasconde il box informativo della cella
+    void SetCellHovered(int32 Index, bool bHovered);
+
 private:
 
-    TArray<TArray<bool>> GridObstacles;
+    // Dati della griglia in formato structure-of-arrays, indicizzati per riga (Y * GridColumns + X)
+    TArray<bool> CellObstacles;
+
+    int32 ActiveGridSeed = 0;
+
+    // Stato dell'inizializzazione: layout in generazione in background, poi creazione delle celle a partire da SpawnCursor
+    bool bGridReady = false;
+
+    TSharedPtr<FGridLayout> PendingLayout;
+
+    UE::Tasks::TTask<void> LayoutTask;
+
+    int32 SpawnCursor = 0;
+
+    double InitializationStartTime = 0.0;
+
+    TArray<bool> CellOccupied;
+
+    UPROPERTY()
+    TArray<ABaseUnit*> CellUnits;
+
+    FGridSearchContext SearchContext;
+
+    uint32 OccupancyVersion = 1;
+
+    FGridDistanceTable DistanceTable;
+
+    FGridHierarchy Hierarchy;
+
+    // Aree raggiungibili calcolate: le voci con una versione vecchia vengono riusate per i nuovi calcoli
+    TArray<FGridReachableArea> ReachableCache;
+
+    // Celle libere e non occupate, una maschera di bit per riga, aggiornata insieme all'occupazione
+    FGridBitboard WalkableBits;
+
+    // Ricerche di percorso in background e snapshot della griglia che leggono (ricreato dopo ogni cambio di occupazione)
+    FGridPathService PathService;
+
+    TSharedPtr<const FGridSnapshot> GridSnapshot;
+
+    // Aspetto di ogni cella, salvato chunk per chunk (GetTileIndex): caricare un chunk legge un blocco contiguo
+    TArray<EGridCellVisual> CellVisuals;
+
+    // Texture di evidenziazione condivisa da tutte le celle e copia dei suoi texel lato CPU
+    UPROPERTY(Transient)
+    UTexture2D* HighlightTexture;
+
+    TArray<FColor> HighlightPixels;
+
+    // Area della texture modificata dall'ultimo aggiornamento (Max escluso)
+    FIntRect HighlightDirtyRect;
+    bool bHighlightDirty = false;
+
+    // Materiali per aspetto (normale, albero, montagna) delle celle: istanze con la texture gi assegnata,
+    // oppure i materiali di base se non leggono la texture
+    UPROPERTY(Transient)
+    TArray<UMaterialInterface*> CellMaterials;
+
+    // I materiali delle celle leggono la texture di evidenziazione
+    bool bUseHighlightTexture = false;
+
+    // Senza la texture: celle evidenziate, celle cambiate dall'ultimo aggiornamento e, con le istanze,
+    // una componente di lastre per ogni colore usato
+    TSet<int32> HighlightedCells;
+    TArray<int32> ChangedHighlightCells;
+
+    UPROPERTY()
+    TArray<UInstancedStaticMeshComponent*> HighlightOverlays;
+
+    TArray<FColor> HighlightOverlayColors;
+
+    // Numero di chunk lungo X e Y
+    int32 ChunkCountX = 0;
+    int32 ChunkCountY = 0;
+
+    // Componenti dei chunk caricati (3 per chunk, una per aspetto) e componenti liberate pronte per essere riusate
+    UPROPERTY()
+    TArray<UInstancedStaticMeshComponent*> ChunkComponents;
+
+    UPROPERTY()
+    TArray<UInstancedStaticMeshComponent*> FreeChunkComponents;
+
+    TArray<bool> ChunkLoaded;
+
+    TArray<int32> LoadedChunks;
+
+    // Area di chunk richiesta nell'ultimo aggiornamento e presenza di chunk ancora da caricare
+    FIntRect LastStreamingRect;
+    bool bStreamingPending = false;
+
+    // Posizione nei dati visivi della cella con indice Index (ordinamento per chunk)
+    int32 GetTileIndex(int32 Index) const;
+
+    // Offset che centra la griglia sull'origine
+    FVector GetGridOriginOffset() const;
+
+    // Carica o scarica i chunk in base all'area inquadrata dalla telecamera
+    void UpdateStreaming();
+    void LoadChunk(int32 ChunkIndex);
+    void UnloadChunk(int32 ChunkIndex);
+    UInstancedStaticMeshComponent* AcquireChunkComponent(EGridCellVisual Visual);
+
+    // Genera ostacoli e aspetto delle celle: usa solo il layout, quindi pu girare su un altro thread
+    static void BuildLayout(FGridLayout& Layout);
+
+    // Posizione nei dati visivi della cella (X, Y) con chunk di lato ChunkSize (ordinamento per chunk)
+    static int32 ComputeTileIndex(int32 X, int32 Y, int32 InChunkSize, int32 InChunkCountX);
+
+    // Avanza l'inizializzazione nel tick, rispettando SpawnBudgetMs
+    void UpdateInitialization();
+
+    // Copia il layout generato nei dati della griglia e prepara la creazione delle celle
+    void ApplyLayout(FGridLayout& Layout);
+
+    void FinishInitialization();
+
+    // Crea l'attore AGridCell della cella
+    void SpawnCellActor(int32 Index);
+
+    // Aggiunge le celle [Begin, End) alle componenti instanziate con una sola chiamata per componente
+    void AddCellInstances(int32 Begin, int32 End);
+
+    // Crea la texture di evidenziazione e i materiali condivisi che la leggono
+    void CreateHighlightResources();
+
+    UMaterialInterface* GetCellMaterial(EGridCellVisual Visual) const;
+
+    // Scrive il texel della cella e allarga l'area da aggiornare
+    void SetHighlightPixel(int32 Index, const FColor& Pixel);
+
+    // Invia alla GPU, con un solo aggiornamento, l'area della texture modificata nel frame
+    void FlushHighlights();
 
-    // Funzioni per la generazione e controllo degli ostacoli
-    void GenerateObstacles();
-    bool IsGridFullyConnected();
-    TSet<FGridPosition> FindConnectedCells(const FGridPosition& Start);
+    // Applica le evidenziazioni cambiate quando i materiali non leggono la texture
+    void FlushHighlightsWithoutTexture();
 
     static AGridManager* Instance;
     void EndPlay(const EEndPlayReason::Type EndPlayReason);
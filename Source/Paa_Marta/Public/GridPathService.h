@@ -0,0 +1,95 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GridHierarchy.h"
+#include "GridPathfinder.h"
+#include "HAL/CriticalSection.h"
+#include "Tasks/Task.h"
+
+// Risultato di una richiesta di percorso: dalla partenza all'obiettivo, estremi inclusi (vuoto se non esiste)
+DECLARE_DELEGATE_OneParam(FOnGridPathReady, const TArray<int32>& /* Path */);
+
+// Copia immutabile di ostacoli e occupazione: le ricerche in background leggono solo questa,
+// mentre la griglia pu continuare a cambiare sul game thread
+struct FGridSnapshot
+{
+    int32 Rows = 0;
+    int32 Columns = 0;
+    TArray<bool> Obstacles;
+    TArray<bool> Occupied;
+
+    // Algoritmo delle ricerche sulla griglia (PathAlgorithm del GridManager)
+    EGridPathAlgorithm Algorithm = EGridPathAlgorithm::AStar;
+
+    // Copia del grafo gerarchico allineata all'occupazione dello snapshot (nullptr sulle griglie piccole).
+    // FindPath usa buffer interni al grafo, quindi le ricerche sullo stesso snapshot lo usano una alla volta
+    TSharedPtr<FGridHierarchy> Hierarchy;
+    mutable FCriticalSection HierarchyLock;
+};
+
+// Ricerche di percorso eseguite su task in background, posseduto dal GridManager. Ogni ricerca usa FGridPathfinder
+// con l'algoritmo dello snapshot, oppure il grafo gerarchico se lo snapshot ne ha uno; le richieste con la stessa partenza e lo stesso obiettivo sullo stesso snapshot
+// condividono una sola ricerca, quindi finch l'occupazione non cambia un percorso non viene ricalcolato
+class PAA_MARTA_API FGridPathService
+{
+public:
+
+    // Registra una richiesta e restituisce il suo handle. MaxCost limita la lunghezza del percorso
+    // (INDEX_NONE = nessun limite): se il percorso minimo  pi lungo il risultato  vuoto. La callback viene sempre chiamata dal game thread, in un Update successivo
+    int32 RequestPath(const TSharedRef<const FGridSnapshot>& Snapshot, int32 Start, int32 Goal, int32 MaxCost, FOnGridPathReady Callback);
+
+    // Annulla una richiesta non ancora consegnata: la sua callback non verr chiamata
+    void CancelRequest(int32 Handle);
+
+    // Avvia le ricerche registrate dall'ultimo Update e consegna i risultati di quelle completate. Solo dal game thread
+    void Update();
+
+    // Scarta richieste e risultati (le ricerche gi avviate finiscono da sole sui propri dati)
+    void Reset();
+
+    FORCEINLINE bool HasPendingRequests() const { return Requests.Num() > 0; }
+
+    // Numero di ricerche avviate finora, per verificare quante richieste sono state raggruppate
+    FORCEINLINE int32 GetLaunchedSearchCount() const { return LaunchedSearchCount; }
+
+private:
+
+    // Percorso da Start a Goal con le regole di FGridPathfinder::FindPath: le celle occupate possono essere
+    // obiettivo ma non vengono attraversate. MaxCost  il limite pi stretto tra le richieste che la condividono
+    struct FSearch
+    {
+        int32 Start = INDEX_NONE;
+        int32 Goal = INDEX_NONE;
+        int32 MaxCost = MAX_int32;
+        TSharedPtr<const FGridSnapshot> Snapshot;
+
+        TArray<int32> Path;
+
+        UE::Tasks::TTask<void> Task;
+        bool bLaunched = false;
+
+        bool IsCompleted() const { return bLaunched && Task.IsCompleted(); }
+    };
+
+    struct FRequest
+    {
+        int32 Handle = INDEX_NONE;
+        int32 MaxCost = MAX_int32;
+        FOnGridPathReady Callback;
+        TSharedPtr<FSearch> Search;
+    };
+
+    static void RunSearch(FSearch& Search);
+
+    // Percorso della ricerca per una richiesta con limite MaxCost (vuoto se pi lungo)
+    static void BuildPath(const FSearch& Search, int32 MaxCost, TArray<int32>& OutPath);
+
+    TArray<TSharedPtr<FSearch>> Searches;
+    TArray<FRequest> Requests;
+
+    // Snapshot dell'ultima richiesta: le ricerche su snapshot pi vecchi vengono scartate appena non servono pi
+    TSharedPtr<const FGridSnapshot> LatestSnapshot;
+
+    int32 NextHandle = 0;
+    int32 LaunchedSearchCount = 0;
+};
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GridPathfinder.generated.h"
+
+// Algoritmo usato da FGridPathfinder::FindPath: entrambi restituiscono percorsi di lunghezza minima
+UENUM()
+enum class EGridPathAlgorithm : uint8
+{
+    // A* cella per cella
+    AStar UMETA(DisplayName = "A*"),
+    // Jump Point Search: salta i tratti rettilinei ed espande solo i punti in cui il percorso pu svoltare
+    JumpPoint UMETA(DisplayName = "Jump Point Search")
+};
+
+// Ricerca di percorsi sulla griglia (4 direzioni, costo 1 per passo). Lavora sugli array piatti del GridManager
+// (indice = Y * Columns + X) e non dipende dagli attori, cos pu essere usata anche dal benchmark
+struct PAA_MARTA_API FGridPathfinder
+{
+    // A* con euristica Manhattan e open list su heap binario indicizzato. Ostacoli e celle occupate non sono
+    // attraversabili, tranne Goal. Il percorso include Start e Goal; restituisce false se Goal non  raggiungibile.
+    // I buffer della ricerca vengono presi dal contesto
+    static bool FindPath(int32 Rows, int32 Columns, const TArray<bool>& Obstacles, const TArray<bool>& Occupied,
+        int32 Start, int32 Goal, struct FGridSearchContext& Context, TArray<int32>& OutPath,
+        EGridPathAlgorithm Algorithm = EGridPathAlgorithm::AStar);
+
+    // Misura il tempo medio di una ricerca per ogni dimensione di griglia e lo scrive nel log
+    static void RunBenchmark(const TArray<int32>& GridSizes, int32 QueriesPerSize, int32 Seed);
+
+    // Confronta A* e Jump Point Search sulle stesse coppie di celle: nodi espansi, tempo e lunghezza dei percorsi
+    static void RunJumpPointBenchmark(const TArray<int32>& GridSizes, int32 QueriesPerSize, int32 Seed);
+
+private:
+
+    // Jump Point Search per movimento in 4 direzioni. I percorsi minimi vengono considerati in forma canonica
+    // (prima orizzontale, poi verticale, con svolte orizzontali solo dove un ostacolo le rende necessarie):
+    // i tratti orizzontali si fermano dove un salto verticale trova un punto di svolta, quelli verticali dove
+    // si apre un passaggio laterale prima chiuso. Le celle intermedie vengono ricostruite alla fine
+    static bool FindPathJumpPoint(int32 Rows, int32 Columns, const TArray<bool>& Obstacles, const TArray<bool>& Occupied,
+        int32 Start, int32 Goal, struct FGridSearchContext& Context, TArray<int32>& OutPath);
+
+    // Versione precedente di ABaseUnit::ComputePath (BFS con TQueue e TMap), usata solo come confronto nel benchmark
+    static bool FindPathBFS(int32 Rows, int32 Columns, const TArray<bool>& Obstacles, const TArray<bool>& Occupied,
+        int32 Start, int32 Goal, TArray<int32>& OutPath);
+};
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Rombo di Manhattan di raggio Radius calcolato a tempo di compilazione: per ogni riga (DeltaY da -Radius a Radius)
+// la mezza larghezza Radius - |DeltaY|, e gli spostamenti (DeltaX, DeltaY) di tutte le celle in ordine di riga
+template<int32 Radius>
+struct TGridDiamond
+{
+    static constexpr int32 NumRows = 2 * Radius + 1;
+    static constexpr int32 NumCells = 2 * Radius * (Radius + 1) + 1;
+
+    int32 HalfWidth[NumRows] = {};
+    int32 OffsetX[NumCells] = {};
+    int32 OffsetY[NumCells] = {};
+
+    constexpr TGridDiamond()
+    {
+        int32 Cell = 0;
+        for (int32 DeltaY = -Radius; DeltaY <= Radius; DeltaY++)
+        {
+            const int32 RowHalfWidth = Radius - (DeltaY < 0 ? -DeltaY : DeltaY);
+            HalfWidth[DeltaY + Radius] = RowHalfWidth;
+            for (int32 DeltaX = -RowHalfWidth; DeltaX <= RowHalfWidth; DeltaX++)
+            {
+                OffsetX[Cell] = DeltaX;
+                OffsetY[Cell] = DeltaY;
+                Cell++;
+            }
+        }
+    }
+};
+
+// Vista su uno dei rombi precalcolati, usata a runtime quando il raggio arriva dalle propriet delle unit
+struct FGridDiamondView
+{
+    int32 Radius = INDEX_NONE;
+    int32 NumCells = 0;
+    const int32* HalfWidth = nullptr;
+    const int32* OffsetX = nullptr;
+    const int32* OffsetY = nullptr;
+
+    FORCEINLINE bool IsValid() const { return HalfWidth != nullptr; }
+};
+
+// Rombi dei raggi usati dalle unit: attacco corpo a corpo 1, movimento dello Sniper 3 e del Brawler 6,
+// attacco dello Sniper 10
+struct PAA_MARTA_API FGridRangeTables
+{
+    // Rombo precalcolato del raggio indicato (vista non valida se il raggio non  in tabella)
+    static FGridDiamondView GetDiamond(int32 Radius);
+};
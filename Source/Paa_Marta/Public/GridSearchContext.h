@@ -0,0 +1,184 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Buffer condivisi dalle ricerche sulla griglia (BFS, A*, campi di distanze), posseduti dal GridManager.
+// Dopo il primo utilizzo su una griglia di una certa dimensione una ricerca non alloca pi memoria:
+// - visitato/genitore/costo usano un timbro di generazione, quindi non vanno azzerati tra una ricerca e l'altra
+// - la frontiera FIFO  un buffer circolare preallocato
+struct PAA_MARTA_API FGridSearchContext
+{
+    // Valore di HeapSlot per le celle gi espanse dall'A*
+    static constexpr int32 ClosedSlot = -2;
+
+    // Inizia una nuova ricerca su una griglia di NumCells celle: tutte le celle tornano non visitate in O(1)
+    void BeginSearch(int32 NumCells);
+
+    FORCEINLINE bool IsVisited(int32 Cell) const { return VisitStamp[Cell] == Stamp; }
+
+    // Segna la cella come visitata con il suo genitore e il suo costo
+    FORCEINLINE void Visit(int32 Cell, int32 ParentCell, int32 CellCost)
+    {
+        VisitStamp[Cell] = Stamp;
+        Parent[Cell] = ParentCell;
+        Cost[Cell] = CellCost;
+    }
+
+    FORCEINLINE int32 GetParent(int32 Cell) const { return Parent[Cell]; }
+    FORCEINLINE int32 GetCost(int32 Cell) const { return Cost[Cell]; }
+
+    FORCEINLINE void SetParentAndCost(int32 Cell, int32 ParentCell, int32 CellCost)
+    {
+        Parent[Cell] = ParentCell;
+        Cost[Cell] = CellCost;
+    }
+
+    // Frontiera FIFO: ogni cella entra al pi una volta per ricerca, quindi la capacit non viene mai superata
+    FORCEINLINE bool IsFrontierEmpty() const { return FrontierCount == 0; }
+
+    FORCEINLINE void PushFrontier(int32 Cell)
+    {
+        check(FrontierCount < Frontier.Num());
+        Frontier[(FrontierHead + FrontierCount) & FrontierMask] = Cell;
+        FrontierCount++;
+    }
+
+    FORCEINLINE int32 PopFrontier()
+    {
+        const int32 Cell = Frontier[FrontierHead];
+        FrontierHead = (FrontierHead + 1) & FrontierMask;
+        FrontierCount--;
+        return Cell;
+    }
+
+    // Allocazioni fatte dall'ultima ricerca e da tutte le ricerche finora: dopo il riscaldamento devono restare a zero
+    FORCEINLINE int32 GetLastSearchAllocations() const { return LastSearchAllocations; }
+    FORCEINLINE int64 GetTotalAllocations() const { return TotalAllocations; }
+
+    // Celle estratte dalla open list nell'ultima ricerca, usate dai benchmark per confrontare gli algoritmi
+    FORCEINLINE void CountExpansion() { LastSearchExpansions++; }
+    FORCEINLINE int32 GetLastSearchExpansions() const { return LastSearchExpansions; }
+
+    // Dati per cella dell'A* (validi solo per le celle visitate nella ricerca corrente)
+    TArray<int32> Score;
+    TArray<int32> HeapSlot;
+
+    // Open list dell'A*, riservata per tutte le celle in BeginSearch
+    TArray<int32> Heap;
+
+private:
+
+    void CountAllocation();
+
+    TArray<uint32> VisitStamp;
+    TArray<int32> Parent;
+    TArray<int32> Cost;
+    uint32 Stamp = 0;
+
+    TArray<int32> Frontier;
+    int32 FrontierMask = 0;
+    int32 FrontierHead = 0;
+    int32 FrontierCount = 0;
+
+    int32 LastSearchAllocations = 0;
+    int64 TotalAllocations = 0;
+    int32 LastSearchExpansions = 0;
+};
+
+// Open list dell'A*: heap binario sulle celle, ordinato per F e, a parit, per G pi alto (le celle pi
+// vicine all'obiettivo vengono espanse prima). Position tiene la posizione di ogni cella nell'heap,
+// cos il costo di una cella gi in lista pu essere migliorato senza cercarla.
+// Heap, posizioni e costi sono i buffer del contesto di ricerca, quindi non vengono allocati ad ogni chiamata
+struct FGridOpenList
+{
+    TArray<int32>& Heap;
+    TArray<int32>& Position;
+    const TArray<int32>& F;
+    FGridSearchContext& Context;
+
+    FGridOpenList(FGridSearchContext& InContext)
+        : Heap(InContext.Heap), Position(InContext.HeapSlot), F(InContext.Score), Context(InContext)
+    {
+    }
+
+    bool IsEmpty() const { return Heap.Num() == 0; }
+
+    bool Less(int32 A, int32 B) const
+    {
+        return F[A] < F[B] || (F[A] == F[B] && Context.GetCost(A) > Context.GetCost(B));
+    }
+
+    // Inserisce la cella oppure, se  gi nella lista, la sposta verso l'alto dopo che il suo costo  diminuito.
+    // Le celle nuove devono avere Position a INDEX_NONE
+    void PushOrUpdate(int32 Cell)
+    {
+        int32 Slot = Position[Cell];
+        if (Slot == INDEX_NONE)
+        {
+            Slot = Heap.Add(Cell);
+            Position[Cell] = Slot;
+        }
+        SiftUp(Slot);
+    }
+
+    int32 Pop()
+    {
+        const int32 Top = Heap[0];
+        Position[Top] = FGridSearchContext::ClosedSlot;
+        Context.CountExpansion();
+
+        const int32 Last = Heap.Pop(false);
+        if (Heap.Num() > 0)
+        {
+            Heap[0] = Last;
+            Position[Last] = 0;
+            SiftDown(0);
+        }
+        return Top;
+    }
+
+    void SiftUp(int32 Slot)
+    {
+        const int32 Cell = Heap[Slot];
+        while (Slot > 0)
+        {
+            const int32 ParentSlot = (Slot - 1) / 2;
+            if (!Less(Cell, Heap[ParentSlot]))
+            {
+                break;
+            }
+            Heap[Slot] = Heap[ParentSlot];
+            Position[Heap[Slot]] = Slot;
+            Slot = ParentSlot;
+        }
+        Heap[Slot] = Cell;
+        Position[Cell] = Slot;
+    }
+
+    void SiftDown(int32 Slot)
+    {
+        const int32 Cell = Heap[Slot];
+        const int32 Count = Heap.Num();
+        while (true)
+        {
+            int32 Child = Slot * 2 + 1;
+            if (Child >= Count)
+            {
+                break;
+            }
+            if (Child + 1 < Count && Less(Heap[Child + 1], Heap[Child]))
+            {
+                Child++;
+            }
+            if (!Less(Heap[Child], Cell))
+            {
+                break;
+            }
+            Heap[Slot] = Heap[Child];
+            Position[Heap[Slot]] = Slot;
+            Slot = Child;
+        }
+        Heap[Slot] = Cell;
+        Position[Cell] = Slot;
+    }
+};
@@ -5,6 +5,12 @@
 #include "GameFramework/GameModeBase.h"
 #include "MyPlayerController.h"
 #include "BaseUnit.h"
+#include "GridFlowField.h"
+#include "GridBitboard.h"
+#include "TacticsState.h"
+#include "TacticsSearch.h"
+#include "TacticsMcts.h"
+#include "TacticsPlanner.h"
 #include "MyGameMode.generated.h"
 
 UENUM()
@@ -24,6 +30,27 @@ enum class EMovementTurn : uint8
     AI      UMETA(DisplayName = "AI")
 };
 
+// Come l'IA sceglie le azioni del proprio turno
+UENUM()
+enum class EAIEngine : uint8
+{
+    // Attacca il primo nemico nel raggio, altrimenti si avvicina al pi vicino
+    Heuristic UMETA(DisplayName = "Heuristic"),
+    // Ricerca alpha-beta/expectimax su FTacticsState entro il tempo del turno
+    Search UMETA(DisplayName = "Search"),
+    // Monte Carlo Tree Search con un albero per ogni thread, entro il tempo del turno
+    MonteCarlo UMETA(DisplayName = "Monte Carlo")
+};
+
+// Livello di difficolt dell'IA: decide quanto tempo ha per pensare il proprio turno
+UENUM(BlueprintType)
+enum class EAIDifficulty : uint8
+{
+    Easy    UMETA(DisplayName = "Easy"),
+    Normal  UMETA(DisplayName = "Normal"),
+    Hard    UMETA(DisplayName = "Hard")
+};
+
 UCLASS()
 class PAA_MARTA_API AMyGameMode : public AGameModeBase
 {
@@ -35,7 +62,11 @@ public:
 
     virtual void BeginPlay() override;
 
-    void OnCellHoverEnd(AGridCell* Cell);
+    virtual void Tick(float DeltaTime) override;
+
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+    void OnCellHoverEnd(int32 CellIndex);
 
     // Stato del posizionamento
     UPROPERTY(BlueprintReadOnly, Category = "Game State")
@@ -61,6 +92,40 @@ public:
     UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "HUD")
     TSubclassOf<UGameHUD> HUDGameClass;
 
+    // Motore usato dall'IA per il proprio turno
+    UPROPERTY(EditAnywhere, Category = "AI")
+    EAIEngine AIEngine = EAIEngine::Heuristic;
+
+    // Difficolt dell'IA a ricerca
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI")
+    EAIDifficulty AIDifficulty = EAIDifficulty::Normal;
+
+    // Tempo per pensare l'intero turno dell'IA, in millisecondi, per ogni difficolt
+    UPROPERTY(EditAnywhere, Category = "AI")
+    TMap<EAIDifficulty, float> AIThinkingTimeMs;
+
+    UFUNCTION(BlueprintCallable, Category = "AI")
+    void SetAIDifficulty(EAIDifficulty NewDifficulty);
+
+    // Tempo per pensare della difficolt attuale
+    float GetAIThinkingTimeMs() const;
+
+    // Profondit massima della ricerca, in azioni
+    UPROPERTY(EditAnywhere, Category = "AI", meta = (ClampMin = "1", ClampMax = "64"))
+    int32 AISearchMaxDepth = 16;
+
+    // Dimensione della tabella delle trasposizioni della ricerca, in MB (0 = nessuna tabella)
+    UPROPERTY(EditAnywhere, Category = "AI", meta = (ClampMin = "0", ClampMax = "1024"))
+    int32 AITranspositionTableMB = 16;
+
+    // Thread della ricerca alpha-beta, che condividono la tabella delle trasposizioni
+    UPROPERTY(EditAnywhere, Category = "AI", meta = (ClampMin = "1", ClampMax = "64"))
+    int32 AISearchThreads = 1;
+
+    // Worker della ricerca Monte Carlo (0 = tutti i thread del task graph tranne uno, lasciato al gioco)
+    UPROPERTY(EditAnywhere, Category = "AI", meta = (ClampMin = "0"))
+    int32 AIMctsWorkers = 0;
+
     // Riferimento all'istanza del widget HUD
     UPROPERTY()
     UGameHUD* HUD;
@@ -70,13 +135,13 @@ public:
     void StartUnitPlacement();
 
     UFUNCTION(BlueprintCallable, Category = "Game")
-    void OnGridCellClicked(class AGridCell* Cell);
+    void OnGridCellClicked(int32 CellIndex);
 
     UFUNCTION(BlueprintCallable, Category = "Game")
     void AdvancePlacementTurn();
 
     UFUNCTION(BlueprintCallable, Category = "Game")
-    void SpawnAndPlaceUnit(EUnitType UnitType, ETeamType TeamType, class AGridCell* Cell);
+    void SpawnAndPlaceUnit(EUnitType UnitType, ETeamType TeamType, int32 CellIndex);
 
     // Funzione per posizionamento unit AI
     UFUNCTION(BlueprintCallable, Category = "Game")
@@ -91,7 +156,11 @@ public:
     UFUNCTION()
     void ResetAllCellHighlights();
 
-    TSet<AGridCell*> GetReachableCells(ABaseUnit* Unit);
+    const FGridBitboard& GetReachableCells(ABaseUnit* Unit);
+
+    // Copia griglia, unit vive e turno in uno stato senza attori; OutUnits[i]  l'attore dell'unit i dello stato.
+    // Restituisce false se la griglia  pi grande di quella supportata o le unit sono troppe
+    bool BuildTacticsState(FTacticsState& OutState, TArray<ABaseUnit*>& OutUnits) const;
 
     UFUNCTION()
     void MoveAIUnits(); 
@@ -114,13 +183,13 @@ public:
 
     bool bGameOver;
 
-	void MoveAIUnitsellHoverBegin(AGridCell* Cell); 
+	void OnCellHoverBegin(int32 CellIndex); 
 
     bool PlayerUnitsHaveCompletedAction();
 
 	void EndPlayerTurn();  
 
-    FString GetCellIdentifier(AGridCell* Cell);
+    FString GetCellIdentifier(int32 CellIndex);
 
     void ResetAIUnitsMovement();
 
@@ -131,12 +200,51 @@ private:
     ABaseUnit* PreviewUnit;
 
     // Crea e posiziona un'unit di anteprima
-    void CreateUnitPreview(EUnitType UnitType, ETeamType TeamType, AGridCell* Cell);
+    void CreateUnitPreview(EUnitType UnitType, ETeamType TeamType, int32 CellIndex);
+
+    // Avvia il posizionamento quando il GridManager ha finito di creare la griglia
+    void OnGridInitialized();
 
     // Rimuove l'unit di anteprima
     void DestroyUnitPreview();
 
+    // Campi di distanze verso le unit del giocatore, ricalcolati ad ogni turno dell'IA (i buffer vengono riusati)
+    TArray<FGridFlowField> PlayerFlowFields;
+
     bool bAITurn;
 
+    // Avvia in background la pianificazione del turno dell'IA con la ricerca scelta in AIEngine, su una copia
+    // dello stato; il game thread continua a girare e Tick gioca il piano quando  pronto.
+    // Restituisce false se lo stato non si pu costruire
+    bool StartAIPlanning(double BudgetMs);
+
+    // Gioca il piano sugli attori, un'azione alla volta (i danni reali li tirano gli attori). Se dopo un tiro
+    // un'azione non  pi legale, il resto del turno viene pianificato di nuovo con il tempo che resta
+    void PlayAIPlan(const FTacticsPlan& Plan);
+
+    // Esegue sugli attori un'azione scelta dalla ricerca; Units sono gli attori delle unit dello stato
+    void ExecuteAIAction(FTacticsAction Action, const TArray<ABaseUnit*>& Units);
+
+    FTacticsPlanner AIPlanner;
+
+    // Attori delle unit dello stato da cui  partita la pianificazione: gli indici del piano si riferiscono
+    // a questo array, che non cambia se poi un'unit viene eliminata
+    TArray<TWeakObjectPtr<ABaseUnit>> AIPlanUnits;
+
+    // Inizio del turno dell'IA, per dividere il tempo tra le pianificazioni dello stesso turno
+    double AITurnStartTime = 0.0;
+
+    // Tabella delle trasposizioni della ricerca, allocata al primo turno e mantenuta tra i turni
+    TSharedPtr<FTacticsTranspositionTable> SearchTable;
+
+    // Chiude il turno dell'IA e rid il turno al giocatore
+    void FinishAITurn();
+
+    // Celle evidenziate in questo momento e relativo colore
+    TMap<int32, FLinearColor> HighlightedCells;
+
+    // Porta le evidenziazioni allo stato richiesto aggiornando solo le celle che cambiano
+    void ApplyCellHighlights(const TMap<int32, FLinearColor>& NewHighlights);
+
     bool bAIStartsPlacement;
 };
\ No newline at end of file
@@ -17,7 +17,11 @@ public:
 
 private:
 
-    AGridCell* LastHoveredCell;
+    // Cella sotto il cursore al frame precedente (INDEX_NONE se nessuna)
+    int32 LastHoveredCellIndex = INDEX_NONE;
+
+    // Indice della cella sotto il cursore, con le celle attore o con la griglia instanziata
+    int32 GetCellIndexUnderCursor(class AGridManager* GridManager) const;
 
 protected:
 
@@ -28,5 +32,9 @@ protected:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera")
     ACameraActor* MyTopDownCameraActor;
 
+    // Velocit di spostamento della telecamera con WASD o con le frecce (unit al secondo)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera")
+    float CameraPanSpeed = 2000.0f;
+
     void ProcessPlayerInput(const float DeltaTime, const bool bGamePaused);
 };
\ No newline at end of file
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TacticsState.h"
+#include <atomic>
+
+// Parametri della ricerca Monte Carlo
+struct FTacticsMctsSettings
+{
+    // Tempo a disposizione per scegliere l'azione, in millisecondi
+    double TimeBudgetMs = 100.0;
+
+    // Alberi indipendenti, uno per worker (0 = uno per ogni thread che pu lavorare insieme al chiamante)
+    int32 NumWorkers = 0;
+
+    // I worker girano con priorit di background, per non togliere i thread al motore e al rendering
+    bool bBackgroundPriority = false;
+
+    // Costante di esplorazione di UCT
+    float Exploration = 0.7f;
+
+    // Simulazioni guidate dall'ordinamento della ricerca invece che completamente casuali
+    bool bHeuristicRollouts = true;
+
+    // Azioni massime di una simulazione; oltre si usa la valutazione statica
+    int32 MaxRolloutActions = 40;
+
+    // Archi massimi per albero, per limitare la memoria di ogni worker (16 byte per arco)
+    int32 MaxEdgesPerWorker = 1 << 20;
+
+    int32 Seed = 0;
+
+    // Se impostato da un altro thread i worker si fermano e si usano le simulazioni fatte fino a quel momento
+    const std::atomic<bool>* CancelFlag = nullptr;
+};
+
+// Risultato di una ricerca
+struct FTacticsMctsStats
+{
+    // Alberi che hanno completato almeno una simulazione entro il tempo (gli altri non contano per thread)
+    int32 NumWorkers = 0;
+
+    // Simulazioni completate da tutti i worker
+    int64 Playouts = 0;
+
+    double ElapsedMs = 0.0;
+
+    // Visite e risultato medio (0-1, per chi muove) dell'azione scelta, sommati tra gli alberi
+    int32 BestVisits = 0;
+    float BestValue = 0.f;
+
+    FORCEINLINE double GetPlayoutsPerSecondPerThread() const
+    {
+        return (ElapsedMs > 0.0 && NumWorkers > 0) ? Playouts / (ElapsedMs / 1000.0) / NumWorkers : 0.0;
+    }
+};
+
+// Monte Carlo Tree Search con UCT sulle azioni di FTacticsState (un turno  una sequenza di azioni fino a EndTurn).
+// Parallelizzazione alla radice: ogni worker fa crescere un proprio albero senza condividere nulla, e alla fine
+// le visite delle azioni della radice vengono sommate; vince l'azione pi visitata.
+// Gli attacchi non hanno nodi di probabilit: a ogni discesa i tiri vengono estratti di nuovo (albero "open loop"),
+// quindi un nodo rappresenta una sequenza di azioni e non una posizione esatta
+class PAA_MARTA_API FTacticsMcts
+{
+public:
+
+    // Worker usati con NumWorkers = 0: i thread del task graph, pi il chiamante se non  gi uno di loro
+    // (se la ricerca gira su un task, come nel pianificatore, un albero in pi partirebbe solo a tempo scaduto)
+    static int32 GetDefaultNumWorkers();
+
+    // Sceglie l'azione della squadra di turno entro il tempo indicato
+    static FTacticsAction FindBestAction(const FTacticsState& State, const FTacticsMctsSettings& Settings, FTacticsMctsStats& OutStats);
+
+    // Simulazioni al secondo per thread con 1, 2, 4... worker fino a tutti quelli del task graph, su posizioni casuali
+    static void RunBenchmark(int32 GridSize, double TimeBudgetMs, int32 Seed);
+};
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TacticsState.h"
+#include "TacticsSearch.h"
+#include "TacticsMcts.h"
+#include "Tasks/Task.h"
+#include <atomic>
+
+// Parametri di una pianificazione
+struct FTacticsPlannerSettings
+{
+    // Tempo per l'intero turno, diviso tra le azioni che restano da fare
+    double TimeBudgetMs = 500.0;
+
+    // Ricerca Monte Carlo invece di alpha-beta/expectimax
+    bool bUseMonteCarlo = false;
+
+    FTacticsSearchSettings Search;
+    FTacticsMctsSettings Mcts;
+
+    // Tabella delle trasposizioni condivisa con la pianificazione: il task ne tiene un riferimento,
+    // quindi resta valida anche se chi l'ha avviata viene distrutto prima della fine
+    TSharedPtr<FTacticsTranspositionTable> TranspositionTable;
+};
+
+// Piano di un turno: le azioni in ordine (senza EndTurn) e le statistiche delle ricerche che l'hanno prodotto
+struct FTacticsPlan
+{
+    TArray<FTacticsAction> Actions;
+
+    // Nodi visitati dalla ricerca oppure simulazioni della ricerca Monte Carlo
+    int64 Work = 0;
+    int64 TableProbes = 0;
+    int64 TableHits = 0;
+
+    // Thread usati dalla ricerca Monte Carlo (per le simulazioni al secondo per thread)
+    int32 NumWorkers = 1;
+
+    double ElapsedMs = 0.0;
+
+    // La pianificazione  stata annullata: le azioni sono quelle trovate fino a quel momento
+    bool bCancelled = false;
+};
+
+// Pianifica il turno della squadra di turno su un task in background, lavorando su una copia dello stato:
+// il game thread non aspetta mai e controlla con TakePlan quando il piano  pronto.
+// Ogni azione viene scelta con la ricerca entro la sua parte di tempo, poi applicata alla copia con il danno
+// medio per scegliere la successiva; allo scadere del tempo il piano contiene le migliori azioni trovate
+class PAA_MARTA_API FTacticsPlanner
+{
+public:
+
+    ~FTacticsPlanner();
+
+    // Avvia la pianificazione; una pianificazione precedente non ancora ritirata viene annullata
+    void Start(const FTacticsState& Snapshot, const FTacticsPlannerSettings& Settings);
+
+    FORCEINLINE bool IsRunning() const { return Job.IsValid(); }
+
+    // Se il piano  pronto lo consegna e restituisce true. Solo dal game thread
+    bool TakePlan(FTacticsPlan& OutPlan);
+
+    // Chiede al task di fermarsi e ne aspetta la fine (le ricerche controllano la richiesta ogni 1024 nodi)
+    void Cancel();
+
+    // Pianificazione completa, eseguita dal task ma utilizzabile anche direttamente (per esempio dai benchmark)
+    static FTacticsPlan PlanTurn(const FTacticsState& Snapshot, const FTacticsPlannerSettings& Settings, const std::atomic<bool>* CancelFlag);
+
+private:
+
+    // Dati del task: copia dello stato, parametri e risultato, condivisi solo tramite il puntatore
+    struct FJob
+    {
+        FTacticsState Snapshot;
+        FTacticsPlannerSettings Settings;
+        std::atomic<bool> bCancel { false };
+        FTacticsPlan Plan;
+    };
+
+    TSharedPtr<FJob> Job;
+    UE::Tasks::TTask<void> Task;
+};
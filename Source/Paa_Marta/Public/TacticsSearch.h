@@ -0,0 +1,117 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TacticsState.h"
+#include "TacticsTranspositionTable.h"
+#include "Stats/Stats.h"
+#include <atomic>
+
+DECLARE_STATS_GROUP(TEXT("PAA AI"), STATGROUP_PaaAI, STATCAT_Advanced);
+
+// Parametri di una ricerca
+struct FTacticsSearchSettings
+{
+    // Tempo a disposizione per scegliere l'azione, in millisecondi
+    double TimeBudgetMs = 100.0;
+
+    // Profondit massima (in azioni) dell'approfondimento iterativo
+    int32 MaxDepth = 16;
+
+    // Tabella delle trasposizioni (nullptr per cercare senza): le posizioni gi valutate con un altro
+    // ordine di azioni non vengono cercate di nuovo
+    FTacticsTranspositionTable* TranspositionTable = nullptr;
+
+    // Thread che cercano insieme condividendo la tabella (serve la tabella per averne pi di uno)
+    int32 NumThreads = 1;
+
+    // I thread di supporto girano con priorit di background, per non togliere i worker al motore e al rendering
+    bool bBackgroundPriority = false;
+
+    // Se impostato da un altro thread la ricerca si ferma e restituisce la migliore azione trovata
+    const std::atomic<bool>* CancelFlag = nullptr;
+};
+
+// Risultato di una ricerca, per il log e per sommare le statistiche di un intero turno
+struct FTacticsSearchStats
+{
+    // Posizioni visitate, comprese quelle dell'iterazione interrotta dal tempo
+    int64 Nodes = 0;
+
+    // Ultima profondit completata
+    int32 CompletedDepth = 0;
+
+    double ElapsedMs = 0.0;
+
+    // Valutazione dell'azione scelta dal punto di vista della squadra che muove
+    float Score = 0.f;
+
+    // Ricerche nella tabella delle trasposizioni e quante hanno trovato la posizione
+    int64 TableProbes = 0;
+    int64 TableHits = 0;
+
+    FORCEINLINE double GetNodesPerSecond() const { return ElapsedMs > 0.0 ? Nodes / (ElapsedMs / 1000.0) : 0.0; }
+    FORCEINLINE double GetTableHitRate() const { return TableProbes > 0 ? (double)TableHits / TableProbes : 0.0; }
+};
+
+// Ricerca dell'azione migliore su FTacticsState, un'azione alla volta (movimento, attacco o fine turno),
+// cos la stessa profondit copre l'ordine delle azioni di entrambe le unit e il turno dell'avversario.
+// Le scelte sono nodi alpha-beta (massimo per chi muove alla radice, minimo per l'avversario); ogni attacco
+//  un nodo di probabilit con la media pesata su tutti i danni MinDamage..MaxDamage e sui controattacchi 1-3.
+// Approfondimento iterativo: la profondit cresce finch non finisce il tempo, e ogni iterazione
+// prova per prima l'azione migliore della precedente. Con la tabella delle trasposizioni i nodi di scelta
+// riusano valori e azione migliore delle posizioni gi viste; con pi thread ognuno fa la stessa ricerca
+// partendo da un ordine diverso e i risultati si condividono solo attraverso la tabella
+class PAA_MARTA_API FTacticsSearch
+{
+public:
+
+    // Punteggio di una vittoria: le vittorie pi vicine valgono di pi
+    static constexpr float WinScore = 100000.f;
+
+    // Sceglie l'azione della squadra di turno entro il tempo indicato
+    FTacticsAction FindBestAction(const FTacticsState& InState, const FTacticsSearchSettings& Settings, FTacticsSearchStats& OutStats);
+
+    // Valutazione statica dal punto di vista di Side: vita rimasta, unit vive e distanza utile dai nemici
+    static float Evaluate(const FTacticsState& State, ETeamType Side);
+
+    // Punteggio per l'ordinamento: prima gli attacchi (letali per primi), poi i movimenti verso i nemici
+    static int32 GetOrderingScore(const FTacticsState& State, FTacticsAction Action);
+
+    // Azioni che la squadra di turno pu ancora fare prima di passare il turno (per dividere il tempo del turno)
+    static int32 CountRemainingActions(const FTacticsState& State);
+
+    // Gioca NumPositions posizioni casuali con il tempo indicato per azione, senza e con la tabella delle trasposizioni,
+    // e scrive nel log profondit, nodi al secondo e percentuale di posizioni trovate nella tabella
+    static void RunBenchmark(int32 GridSize, double TimeBudgetMs, int32 NumPositions, int32 Seed);
+
+private:
+
+    // Approfondimento iterativo di un thread; ThreadIndex cambia l'ordine iniziale delle azioni alla radice
+    FTacticsAction RunIterativeDeepening(const FTacticsState& InState, const FTacticsSearchSettings& Settings, int32 ThreadIndex, FTacticsSearchStats& OutStats);
+
+    // Valori salvati nella tabella dal punto di vista di chi muove nel nodo, con le vittorie contate dal nodo
+    // invece che dalla radice: cos valgono in qualunque ricerca
+    float ToTableScore(float Score, int32 Ply) const;
+    float FromTableScore(float Score, int32 Ply) const;
+
+    // Nodo di scelta: massimo se muove la squadra della radice, minimo altrimenti
+    float SearchNode(int32 Depth, int32 Ply, float Alpha, float Beta);
+
+    // Valore di un'azione; per un attacco  la media sugli esiti dei tiri
+    float SearchAction(FTacticsAction Action, int32 Depth, int32 Ply, float Alpha, float Beta);
+
+    // Conta il nodo e controlla il tempo ogni 1024 nodi
+    bool VisitNode();
+
+    FTacticsState State;
+    ETeamType RootSide = (ETeamType)0;
+    double Deadline = 0.0;
+    int64 Nodes = 0;
+    bool bAborted = false;
+    FTacticsTranspositionTable* Table = nullptr;
+    int64 TableProbes = 0;
+    int64 TableHits = 0;
+
+    // Per il thread principale  la richiesta di annullamento, per gli altri  impostato quando il principale ha finito
+    const std::atomic<bool>* StopFlag = nullptr;
+};
@@ -0,0 +1,190 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+enum class EUnitType : uint8;
+enum class ETeamType : uint8;
+class ABaseUnit;
+
+// Tipo di azione, nei 3 bit bassi di FTacticsAction
+enum class ETacticsActionType : uint8
+{
+    // Passa il turno all'altra squadra (possibile solo quando tutte le unit vive hanno agito)
+    EndTurn,
+    // Movimento verso una cella raggiungibile
+    Move,
+    // Attacco a un'unit nemica nel raggio d'attacco
+    Attack,
+    // Movimento fittizio: l'unit resta ferma ma conta come mossa
+    Pass
+};
+
+// Azione codificata in 32 bit:
+// - bit 0-2 tipo, bit 3-4 unit che agisce
+// - Move: bit 16-31 cella di destinazione
+// - Attack: bit 5-6 unit bersaglio, bit 7-11 danno inflitto, bit 12-13 danno del controattacco
+// L'esito dei tiri fa parte dell'azione: la generazione lascia i danni a zero e chi cerca sceglie l'esito
+// con WithOutcome, cos Apply e Undo restano deterministici
+struct FTacticsAction
+{
+    uint32 Bits = 0;
+
+    static FORCEINLINE FTacticsAction EndTurn() { return FTacticsAction{ (uint32)ETacticsActionType::EndTurn }; }
+
+    static FORCEINLINE FTacticsAction Pass(int32 Unit) { return FTacticsAction{ (uint32)ETacticsActionType::Pass | (uint32)Unit << 3 }; }
+
+    static FORCEINLINE FTacticsAction Move(int32 Unit, int32 Cell)
+    {
+        return FTacticsAction{ (uint32)ETacticsActionType::Move | (uint32)Unit << 3 | (uint32)Cell << 16 };
+    }
+
+    static FORCEINLINE FTacticsAction Attack(int32 Unit, int32 Target)
+    {
+        return FTacticsAction{ (uint32)ETacticsActionType::Attack | (uint32)Unit << 3 | (uint32)Target << 5 };
+    }
+
+    // Stesso attacco con i danni indicati (Damage 0-31, CounterDamage 0-3)
+    FORCEINLINE FTacticsAction WithOutcome(int32 Damage, int32 CounterDamage) const
+    {
+        return FTacticsAction{ (Bits & ~(uint32)0x3F80) | (uint32)Damage << 7 | (uint32)CounterDamage << 12 };
+    }
+
+    FORCEINLINE ETacticsActionType GetType() const { return (ETacticsActionType)(Bits & 0x7); }
+    FORCEINLINE int32 GetUnit() const { return (Bits >> 3) & 0x3; }
+    FORCEINLINE int32 GetCell() const { return Bits >> 16; }
+    FORCEINLINE int32 GetTarget() const { return (Bits >> 5) & 0x3; }
+    FORCEINLINE int32 GetDamage() const { return (Bits >> 7) & 0x1F; }
+    FORCEINLINE int32 GetCounterDamage() const { return (Bits >> 12) & 0x3; }
+
+    FORCEINLINE bool operator==(const FTacticsAction& Other) const { return Bits == Other.Bits; }
+    FORCEINLINE bool operator!=(const FTacticsAction& Other) const { return Bits != Other.Bits; }
+};
+
+static_assert(sizeof(FTacticsAction) == 4, "Actions must stay 32 bits");
+
+// Azioni legali di una posizione, in un array di capacit fissa: la generazione non alloca mai.
+// Con due unit per squadra il Brawler ha al pi 84 celle raggiungibili e lo Sniper 24, quindi 256 basta
+struct FTacticsActionList
+{
+    static constexpr int32 MaxActions = 256;
+
+    FTacticsAction Actions[MaxActions];
+    int32 Num = 0;
+
+    FORCEINLINE void Add(FTacticsAction Action)
+    {
+        check(Num < MaxActions);
+        Actions[Num++] = Action;
+    }
+};
+
+// Dati di un'unit copiati dall'attore: statistiche, posizione e flag del turno
+struct FTacticsUnit
+{
+    // Flag del turno
+    static constexpr uint8 MovedFlag = 1;
+    static constexpr uint8 AttackedFlag = 2;
+
+    int32 Cell = INDEX_NONE;
+    int16 Health = 0;
+    int16 HealthMax = 0;
+    uint8 MovementRange = 0;
+    uint8 AttackRange = 0;
+    uint8 MinDamage = 0;
+    uint8 MaxDamage = 0;
+    EUnitType Type = (EUnitType)0;
+    ETeamType Team = (ETeamType)0;
+    bool bRanged = false;
+    uint8 Flags = 0;
+
+    FORCEINLINE bool IsAlive() const { return Health > 0; }
+    FORCEINLINE bool HasMoved() const { return (Flags & MovedFlag) != 0; }
+    FORCEINLINE bool HasAttacked() const { return (Flags & AttackedFlag) != 0; }
+
+    // Copia statistiche, cella, vita e flag del turno dall'attore
+    static FTacticsUnit FromUnit(const ABaseUnit* Unit);
+};
+
+// Informazioni per annullare un'azione, restituite da FTacticsState::Apply
+struct FTacticsUndo
+{
+    uint64 PreviousHash = 0;
+    int32 FromCell = INDEX_NONE;
+    uint8 PreviousFlags[4] = {};
+};
+
+// Stato di gioco senza attori: ostacoli come una maschera di bit per riga, unit, turno e flag.
+// Hash  la chiave Zobrist a 64 bit di cella, vita (fino a MaxHealthBucket), flag di ogni unit e squadra di turno,
+// aggiornata da Apply con qualche XOR: posizioni raggiunte con ordini diversi hanno la stessa chiave.
+//  una struttura semplice da copiare, cos la ricerca dell'IA e i test possono simulare posizioni senza UWorld.
+// Le regole sono quelle degli attori: movimento entro MovementRange su celle libere, attacco dopo
+// il movimento ma non prima, controattacco (1-3) allo Sniper che attacca uno Sniper o un Brawler adiacente
+struct PAA_MARTA_API FTacticsState
+{
+    static constexpr int32 MaxUnits = 4;
+    static constexpr int32 MaxRows = 64;
+    static constexpr int32 MaxColumns = 64;
+    static constexpr int32 MaxCounterDamage = 3;
+    static constexpr int32 MaxHealthBucket = 63;
+
+    int32 Rows = 0;
+    int32 Columns = 0;
+    uint64 ObstacleRows[MaxRows] = {};
+    FTacticsUnit Units[MaxUnits];
+    int32 NumUnits = 0;
+    ETeamType SideToMove = (ETeamType)0;
+    uint64 Hash = 0;
+
+    // Prepara una griglia senza unit; restituisce false se supera MaxRows x MaxColumns
+    bool Init(int32 InRows, int32 InColumns, const TArray<bool>& Obstacles);
+
+    // Aggiunge un'unit e ne restituisce l'indice (INDEX_NONE se le unit sono gi MaxUnits)
+    int32 AddUnit(const FTacticsUnit& Unit);
+
+    // Cambia la squadra di turno mantenendo aggiornato l'hash (SideToMove va modificato solo da qui o da Apply)
+    void SetSideToMove(ETeamType Side);
+
+    // Ricalcola l'hash da zero; Apply lo aggiorna in modo incrementale e deve dare lo stesso risultato
+    uint64 ComputeHash() const;
+
+    // Genera una mappa GridSize x GridSize e piazza le quattro unit (statistiche prese dai default delle classi)
+    // su celle libere casuali, per i benchmark; restituisce false se la griglia  troppo grande
+    bool InitRandom(int32 GridSize, FRandomStream& Stream);
+
+    FORCEINLINE bool IsObstacle(int32 Cell) const { return (ObstacleRows[Cell / Columns] >> (Cell % Columns)) & 1; }
+
+    FORCEINLINE int32 GetDistance(int32 CellA, int32 CellB) const
+    {
+        return FMath::Abs(CellA % Columns - CellB % Columns) + FMath::Abs(CellA / Columns - CellB / Columns);
+    }
+
+    // Unit viva nella cella (INDEX_NONE se la cella  libera)
+    int32 GetUnitAt(int32 Cell) const;
+
+    bool HasLivingUnits(ETeamType Team) const;
+
+    // La partita finisce quando una squadra non ha pi unit vive
+    bool IsGameOver() const;
+
+    // Il bersaglio  nel raggio d'attacco dell'unit (a distanza per lo Sniper, adiacente per il Brawler)
+    bool IsInAttackRange(int32 Attacker, int32 Target) const;
+
+    // L'attacco provoca un controattacco sull'attaccante
+    bool HasCounterattack(int32 Attacker, int32 Target) const;
+
+    // Celle raggiungibili dall'unit, una maschera per riga, calcolate a strati di bit senza allocazioni
+    void GetReachableRows(int32 Unit, uint64 (&OutRows)[MaxRows]) const;
+
+    // Aggiunge a OutActions tutte le azioni legali della squadra di turno e ne restituisce il numero
+    int32 GenerateActions(FTacticsActionList& OutActions) const;
+
+    // Esegue un'azione legale in O(1); le informazioni restituite servono a Undo
+    FTacticsUndo Apply(FTacticsAction Action);
+
+    // Annulla l'ultima azione eseguita con Apply, riportando lo stato esattamente com'era
+    void Undo(FTacticsAction Action, const FTacticsUndo& UndoInfo);
+
+    // Conta le posizioni raggiungibili in Depth azioni con Apply/Undo (attacchi con il danno medio)
+    // e scrive nel log posizioni al secondo, su una mappa generata con il seed indicato
+    static void RunBenchmark(int32 GridSize, int32 Depth, int32 Seed);
+};
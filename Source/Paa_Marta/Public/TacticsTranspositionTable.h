@@ -0,0 +1,89 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TacticsState.h"
+#include <atomic>
+
+// Tipo di valore salvato: esatto, oppure solo un limite perch la ricerca del nodo  stata tagliata
+enum class ETacticsBound : uint8
+{
+    None,
+    Exact,
+    // Il valore vero  almeno questo (taglio beta)
+    Lower,
+    // Il valore vero  al massimo questo (nessuna azione ha superato alpha)
+    Upper
+};
+
+// Voce letta dalla tabella
+struct FTacticsTableEntry
+{
+    float Score = 0.f;
+    int32 Depth = 0;
+    ETacticsBound Bound = ETacticsBound::None;
+    FTacticsAction BestAction;
+};
+
+// Tabella delle trasposizioni a dimensione fissa, condivisa da pi thread di ricerca senza lock.
+// Ogni voce sono due parole da 64 bit: i dati e la chiave Zobrist in XOR con i dati. Una scrittura concorrente
+// pu mescolare le due parole di scritture diverse, ma allora l'XOR non restituisce pi la chiave e la voce
+// viene semplicemente ignorata, quindi bastano letture e scritture atomiche rilassate.
+// Le voci sono in secchi da 4 allineati alla linea di cache (64 byte): una ricerca tocca una sola linea
+class PAA_MARTA_API FTacticsTranspositionTable
+{
+public:
+
+    static constexpr int32 EntriesPerBucket = 4;
+    static constexpr int32 MaxDepth = 31;
+
+    FTacticsTranspositionTable() = default;
+    ~FTacticsTranspositionTable();
+
+    FTacticsTranspositionTable(const FTacticsTranspositionTable&) = delete;
+    FTacticsTranspositionTable& operator=(const FTacticsTranspositionTable&) = delete;
+
+    // Alloca la tabella con il numero di secchi potenza di due pi grande che sta in SizeMB megabyte
+    void Init(int32 SizeMB);
+
+    // Svuota la tabella (da non chiamare mentre ci sono ricerche in corso)
+    void Clear();
+
+    FORCEINLINE bool IsValid() const { return Buckets != nullptr; }
+
+    // Nuova ricerca: le voci delle ricerche precedenti restano utilizzabili ma vengono sostituite per prime
+    FORCEINLINE void NewSearch() { Generation = (Generation + 1) & 3; }
+
+    // Cerca la posizione; restituisce false se non c'
+    bool Probe(uint64 Key, FTacticsTableEntry& OutEntry) const;
+
+    // Salva il risultato di un nodo: sostituisce la stessa posizione, poi una voce vecchia o la meno profonda del secchio
+    void Store(uint64 Key, float Score, int32 Depth, ETacticsBound Bound, FTacticsAction BestAction);
+
+    FORCEINLINE int64 GetSizeBytes() const { return (int64)NumBuckets * sizeof(FBucket); }
+
+private:
+
+    struct FEntry
+    {
+        std::atomic<uint64> CheckedKey;
+        std::atomic<uint64> Data;
+    };
+
+    struct alignas(64) FBucket
+    {
+        FEntry Entries[EntriesPerBucket];
+    };
+
+    static_assert(sizeof(FBucket) == 64, "A bucket must fill exactly one cache line");
+
+    // Dati di una voce in 64 bit: valore (32), azione compressa (23), profondit (5), tipo (2), generazione (2)
+    static uint64 PackData(float Score, int32 Depth, ETacticsBound Bound, FTacticsAction BestAction, uint32 InGeneration);
+    static FTacticsTableEntry UnpackData(uint64 Data);
+
+    FORCEINLINE static int32 GetDataDepth(uint64 Data) { return (int32)((Data >> 55) & 0x1F); }
+    FORCEINLINE static uint32 GetDataGeneration(uint64 Data) { return (uint32)(Data >> 62); }
+
+    FBucket* Buckets = nullptr;
+    uint64 NumBuckets = 0;
+    uint32 Generation = 0;
+};